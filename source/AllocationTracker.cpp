@@ -0,0 +1,111 @@
+#include "pch.h"
+#include "AllocationTracker.h"
+
+using namespace dae;
+
+//constant initialized, operator new can count before anything else is constructed
+AllocationTracker::RunningCounters AllocationTracker::m_RunningCounters[m_AmountOfSubsystems]{};
+AllocationTracker::FrameCounters AllocationTracker::m_LastFrame{};
+
+#ifdef TRACK_ALLOCATIONS
+//the array and nothrow forms, and the sized deletes, all end up in these
+void* operator new(size_t bytes)
+{
+	AllocationTracker::CountAllocation(bytes);
+
+	//every new returns its own pointer, even for 0 bytes
+	if (void* pMemory{ std::malloc(bytes > 0 ? bytes : 1) })
+	{
+		return pMemory;
+	}
+
+	throw std::bad_alloc{};
+}
+
+void* operator new(size_t bytes, std::align_val_t alignment)
+{
+	AllocationTracker::CountAllocation(bytes);
+
+	if (void* pMemory{ _aligned_malloc(bytes > 0 ? bytes : 1, static_cast<size_t>(alignment)) })
+	{
+		return pMemory;
+	}
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::align_val_t) noexcept
+{
+	_aligned_free(pMemory);
+}
+#endif
+
+void AllocationTracker::CountAllocation(size_t bytes)
+{
+	if constexpr (m_IsEnabled)
+	{
+		RunningCounters& counters{ m_RunningCounters[static_cast<int>(m_CurrentSubsystem)] };
+		counters.allocations.fetch_add(1, std::memory_order_relaxed);
+		counters.allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+}
+
+void AllocationTracker::CountCopy(size_t bytes)
+{
+	if constexpr (m_IsEnabled)
+	{
+		if (bytes < m_LargeCopyBytes)
+		{
+			return;
+		}
+
+		RunningCounters& counters{ m_RunningCounters[static_cast<int>(m_CurrentSubsystem)] };
+		counters.copies.fetch_add(1, std::memory_order_relaxed);
+		counters.copiedBytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+}
+
+void AllocationTracker::EndFrame()
+{
+	for (int subsystemIdx{ 0 }; subsystemIdx < m_AmountOfSubsystems; ++subsystemIdx)
+	{
+		RunningCounters& runningCounters{ m_RunningCounters[subsystemIdx] };
+		Counters& counters{ m_LastFrame.subsystems[subsystemIdx] };
+
+		counters.allocations = runningCounters.allocations.exchange(0, std::memory_order_relaxed);
+		counters.allocatedBytes = runningCounters.allocatedBytes.exchange(0, std::memory_order_relaxed);
+		counters.copies = runningCounters.copies.exchange(0, std::memory_order_relaxed);
+		counters.copiedBytes = runningCounters.copiedBytes.exchange(0, std::memory_order_relaxed);
+	}
+}
+
+const AllocationTracker::FrameCounters& AllocationTracker::GetLastFrame()
+{
+	return m_LastFrame;
+}
+
+void AllocationTracker::PrintLastFrame()
+{
+	constexpr float bytesToKiB{ 1.f / 1024.f };
+
+	std::cout << "Allocations:";
+	for (int subsystemIdx{ 0 }; subsystemIdx < m_AmountOfSubsystems; ++subsystemIdx)
+	{
+		const Counters& counters{ m_LastFrame.subsystems[subsystemIdx] };
+		std::cout << " " << GetSubsystemName(static_cast<Subsystem>(subsystemIdx)) << " " << counters.allocations << " (" << counters.allocatedBytes * bytesToKiB << " KiB)";
+	}
+	std::cout << std::endl;
+
+	std::cout << "Large copies:";
+	for (int subsystemIdx{ 0 }; subsystemIdx < m_AmountOfSubsystems; ++subsystemIdx)
+	{
+		const Counters& counters{ m_LastFrame.subsystems[subsystemIdx] };
+		std::cout << " " << GetSubsystemName(static_cast<Subsystem>(subsystemIdx)) << " " << counters.copies << " (" << counters.copiedBytes * bytesToKiB << " KiB)";
+	}
+	std::cout << std::endl;
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+
+namespace dae
+{
+	// Parts of the program heap allocations and large copies are counted for
+	enum class Subsystem
+	{
+		renderer,
+		mesh,
+		texture,
+		utils,
+		other
+	};
+
+	inline const char* GetSubsystemName(Subsystem subsystem)
+	{
+		constexpr const char* names[]{ "RENDERER", "MESH", "TEXTURE", "UTILS", "OTHER" };
+		return names[static_cast<int>(subsystem)];
+	}
+
+	// Heap allocations, allocated bytes and large copies per frame and per subsystem, for builds that define TRACK_ALLOCATIONS
+	// (the Debug configuration does, a profiling Release build can add it). Those builds replace the global operator new to count
+	// every allocation for the subsystem whose Scope is innermost on the allocating thread, "other" when none is open.
+	// Scopes do not follow work onto other threads, the body of a parallel loop opens one for the subsystem that started it.
+	// Without the define nothing is replaced and every count compiles to nothing
+	class AllocationTracker final
+	{
+	public:
+		// CONSTANTS
+#ifdef TRACK_ALLOCATIONS
+		static constexpr bool m_IsEnabled{ true };
+#else
+		static constexpr bool m_IsEnabled{ false };
+#endif
+		static constexpr int m_AmountOfSubsystems{ 5 };
+
+		//copies below this are not worth a count
+		static constexpr size_t m_LargeCopyBytes{ 4 * 1024 };
+
+		// STRUCTS
+		struct Counters
+		{
+			uint64_t allocations{};
+			uint64_t allocatedBytes{};
+			uint64_t copies{};
+			uint64_t copiedBytes{};
+		};
+
+		struct FrameCounters
+		{
+			Counters subsystems[m_AmountOfSubsystems]{};
+		};
+
+		// Everything the thread allocates or copies until the scope closes counts for the subsystem
+		class Scope final
+		{
+		public:
+			explicit Scope(Subsystem subsystem)
+			{
+				if constexpr (m_IsEnabled)
+				{
+					m_PreviousSubsystem = m_CurrentSubsystem;
+					m_CurrentSubsystem = subsystem;
+				}
+			}
+
+			~Scope()
+			{
+				if constexpr (m_IsEnabled)
+				{
+					m_CurrentSubsystem = m_PreviousSubsystem;
+				}
+			}
+
+			Scope(const Scope& other) = delete;
+			Scope& operator=(const Scope& other) = delete;
+			Scope(Scope&& other) noexcept = delete;
+			Scope& operator=(Scope&& other) noexcept = delete;
+
+		private:
+			Subsystem m_PreviousSubsystem{ Subsystem::other };
+		};
+
+		// MEMBER FUNCTIONS
+		//what the calling thread counts for, so a parallel loop can open the same scope on its workers
+		static Subsystem GetCurrentSubsystem()
+		{
+			return m_CurrentSubsystem;
+		}
+
+		static void CountAllocation(size_t bytes);
+		static void CountCopy(size_t bytes);
+
+		//the counts since the last call become the last frame's, called once per frame
+		static void EndFrame();
+		static const FrameCounters& GetLastFrame();
+		static void PrintLastFrame();
+
+	private:
+		// STRUCTS
+		//any thread can allocate while a frame runs
+		struct RunningCounters
+		{
+			std::atomic<uint64_t> allocations{};
+			std::atomic<uint64_t> allocatedBytes{};
+			std::atomic<uint64_t> copies{};
+			std::atomic<uint64_t> copiedBytes{};
+		};
+
+		// MEMBER VARIABLES
+		inline static thread_local Subsystem m_CurrentSubsystem{ Subsystem::other };
+
+		static RunningCounters m_RunningCounters[m_AmountOfSubsystems];
+		static FrameCounters m_LastFrame;
+	};
+}
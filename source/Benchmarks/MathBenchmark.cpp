@@ -0,0 +1,148 @@
+#include "ReferenceMath.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+using namespace dae;
+
+//keeps the compiler from dropping loops whose results are never read
+static volatile float g_Sink{};
+
+//fastest of a few runs, in nanoseconds per element
+template<typename Function>
+static double Measure(Function function, size_t amountOfElements)
+{
+	constexpr int amountOfRuns{ 30 };
+	double best{ DBL_MAX };
+
+	for (int run{ 0 }; run < amountOfRuns; ++run)
+	{
+		const auto start{ std::chrono::high_resolution_clock::now() };
+		function();
+		const auto end{ std::chrono::high_resolution_clock::now() };
+
+		best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / amountOfElements);
+	}
+
+	return best;
+}
+
+static void PrintRow(const char* name, double referenceTime, double headerTime)
+{
+	std::cout << "\t " << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(8) << referenceTime << " -> " << std::setw(6) << headerTime << " (" << std::setprecision(1) << referenceTime / headerTime << "x)" << std::endl;
+}
+
+static bool AreIdentical(const Vector4& v1, const Vector4& v2)
+{
+	return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z && v1.w == v2.w;
+}
+
+int main()
+{
+	constexpr size_t amountOfPoints{ 1 << 16 };
+	constexpr size_t amountOfMatrices{ 1024 };
+
+	std::mt19937 generator{ 1 };
+	std::uniform_real_distribution<float> distribution{ -2.f, 2.f };
+
+	std::vector<Vector3> pointsA(amountOfPoints);
+	std::vector<Vector3> pointsB(amountOfPoints);
+	for (size_t idx{ 0 }; idx < amountOfPoints; ++idx)
+	{
+		pointsA[idx] = Vector3{ distribution(generator), distribution(generator), distribution(generator) };
+		pointsB[idx] = Vector3{ pointsA[idx].z, pointsA[idx].x, pointsA[idx].y };
+	}
+
+	const Matrix matrix{ Matrix::CreateRotation(0.3f, 0.7f, 0.1f) * Matrix::CreateTranslation(1.f, 2.f, 3.f) * Matrix::CreatePerspectiveFovLH(1.f, 1.3f, 0.1f, 100.f) };
+	const std::vector<Matrix> matrices(amountOfMatrices, matrix);
+
+	std::vector<Vector4> points4(amountOfPoints);
+	for (size_t idx{ 0 }; idx < amountOfPoints; ++idx)
+	{
+		points4[idx] = Vector4{ pointsA[idx], 1.f };
+	}
+
+	std::vector<Vector3> results(amountOfPoints);
+	std::vector<Vector4> transformed(amountOfPoints);
+
+	std::cout << "[MATH BENCHMARK] out of line scalar reference -> header math, ns per element" << std::endl;
+
+	PrintRow("Vector3 a + b * 0.5f",
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) results[idx] = reference::Add(pointsA[idx], reference::Scale(pointsB[idx], 0.5f)); }, amountOfPoints),
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) results[idx] = pointsA[idx] + pointsB[idx] * 0.5f; }, amountOfPoints));
+
+	PrintRow("Vector3::Dot",
+		Measure([&]() { float sum{}; for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) sum += reference::Dot(pointsA[idx], pointsB[idx]); g_Sink = sum; }, amountOfPoints),
+		Measure([&]() { float sum{}; for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) sum += Vector3::Dot(pointsA[idx], pointsB[idx]); g_Sink = sum; }, amountOfPoints));
+
+	PrintRow("Vector3::Normalized",
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) results[idx] = reference::Normalized(pointsA[idx]); }, amountOfPoints),
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) results[idx] = pointsA[idx].Normalized(); }, amountOfPoints));
+
+	PrintRow("Matrix * Matrix",
+		Measure([&]() { Matrix product{ matrix }; for (const Matrix& m : matrices) product = reference::Multiply(m, product); g_Sink = product[0][0]; }, amountOfMatrices),
+		Measure([&]() { Matrix product{ matrix }; for (const Matrix& m : matrices) product = m * product; g_Sink = product[0][0]; }, amountOfMatrices));
+
+	PrintRow("Matrix::TransformPoint",
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) transformed[idx] = reference::TransformPoint(matrix, Vector4{ pointsA[idx], 1.f }); }, amountOfPoints),
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) transformed[idx] = matrix.TransformPoint(Vector4{ pointsA[idx], 1.f }); }, amountOfPoints));
+
+	PrintRow("Matrix::TransformPoints(Vector3)",
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) transformed[idx] = reference::TransformPoint(matrix, Vector4{ pointsA[idx], 1.f }); }, amountOfPoints),
+		Measure([&]() { matrix.TransformPoints(pointsA.data(), transformed.data(), amountOfPoints); }, amountOfPoints));
+
+	PrintRow("Matrix::TransformPoints(Vector4)",
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) transformed[idx] = reference::TransformPoint(matrix, points4[idx]); }, amountOfPoints),
+		Measure([&]() { matrix.TransformPoints(points4.data(), transformed.data(), amountOfPoints); }, amountOfPoints));
+
+	PrintRow("Matrix::TransformVector",
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) results[idx] = reference::TransformVector(matrix, pointsA[idx]); }, amountOfPoints),
+		Measure([&]() { for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) results[idx] = matrix.TransformVector(pointsA[idx]); }, amountOfPoints));
+
+	PrintRow("1.f / sqrtf -> FastInverseSqrt",
+		Measure([&]() { float sum{}; for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) sum += 1.f / sqrtf(pointsA[idx].SqrMagnitude()); g_Sink = sum; }, amountOfPoints),
+		Measure([&]() { float sum{}; for (size_t idx{ 0 }; idx < amountOfPoints; ++idx) sum += FastInverseSqrt(pointsA[idx].SqrMagnitude()); g_Sink = sum; }, amountOfPoints));
+
+	//the header math has to give the same bits as the reference, not just be faster
+	bool isIdentical{ true };
+	const Matrix referenceProduct{ reference::Multiply(matrices[0], matrix) };
+	const Matrix headerProduct{ matrices[0] * matrix };
+	for (int row{ 0 }; row < 4; ++row)
+	{
+		isIdentical &= AreIdentical(referenceProduct[row], headerProduct[row]);
+	}
+
+	std::vector<Vector4> transformed4(amountOfPoints);
+	matrix.TransformPoints(pointsA.data(), transformed.data(), amountOfPoints);
+	matrix.TransformPoints(points4.data(), transformed4.data(), amountOfPoints);
+
+	for (size_t idx{ 0 }; idx < amountOfPoints; ++idx)
+	{
+		const Vector4 point{ pointsA[idx], 1.f };
+		isIdentical &= AreIdentical(reference::TransformPoint(matrix, point), transformed[idx]);
+		isIdentical &= AreIdentical(reference::TransformPoint(matrix, point), transformed4[idx]);
+		isIdentical &= AreIdentical(reference::TransformPoint(matrix, point), matrix.TransformPoint(point));
+		isIdentical &= AreIdentical(Vector4{ reference::Normalized(pointsA[idx]), 0.f }, Vector4{ pointsA[idx].Normalized(), 0.f });
+		isIdentical &= AreIdentical(Vector4{ reference::TransformVector(matrix, pointsA[idx]), 0.f }, Vector4{ matrix.TransformVector(pointsA[idx]), 0.f });
+	}
+
+	//the reciprocal square root is an approximation, it is held to a relative error over six decades of input instead
+	constexpr double maxAllowedError{ 1e-6 };
+	double maxRelativeError{};
+	for (int step{ 1 }; step < 1000000; ++step)
+	{
+		const float value{ step * 0.001f };
+		const double expected{ 1.0 / std::sqrt(double(value)) };
+		maxRelativeError = std::max(maxRelativeError, std::abs(FastInverseSqrt(value) - expected) / expected);
+	}
+
+	const bool isAccurate{ maxRelativeError <= maxAllowedError };
+
+	std::cout << "\t bit identical results: " << (isIdentical ? "yes" : "no") << std::endl;
+	std::cout << "\t FastInverseSqrt max relative error: " << std::scientific << std::setprecision(2) << maxRelativeError << " (allowed " << maxAllowedError << ")" << std::endl;
+	return isIdentical && isAccurate ? 0 : 1;
+}
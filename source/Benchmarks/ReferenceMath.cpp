@@ -0,0 +1,74 @@
+#include "ReferenceMath.h"
+#include <utility>
+
+namespace reference
+{
+	static float Dot(const dae::Vector4& v1, const dae::Vector4& v2)
+	{
+		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+	}
+
+	dae::Vector3 Add(const dae::Vector3& v1, const dae::Vector3& v2)
+	{
+		return { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z };
+	}
+
+	dae::Vector3 Scale(const dae::Vector3& v, float scale)
+	{
+		return { v.x * scale, v.y * scale, v.z * scale };
+	}
+
+	float Dot(const dae::Vector3& v1, const dae::Vector3& v2)
+	{
+		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+	}
+
+	dae::Vector3 Normalized(const dae::Vector3& v)
+	{
+		const float m = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+		return { v.x / m, v.y / m, v.z / m };
+	}
+
+	//a transposed copy of the right-hand side and a dot product per element
+	dae::Matrix Multiply(const dae::Matrix& m1, const dae::Matrix& m2)
+	{
+		dae::Matrix transposed{ m2 };
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			for (int c{ r + 1 }; c < 4; ++c)
+			{
+				std::swap(transposed[r][c], transposed[c][r]);
+			}
+		}
+
+		dae::Matrix result{};
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				result[r][c] = Dot(m1[r], transposed[c]);
+			}
+		}
+
+		return result;
+	}
+
+	dae::Vector4 TransformPoint(const dae::Matrix& m, const dae::Vector4& p)
+	{
+		return dae::Vector4{
+			m[0].x * p.x + m[1].x * p.y + m[2].x * p.z + m[3].x,
+			m[0].y * p.x + m[1].y * p.y + m[2].y * p.z + m[3].y,
+			m[0].z * p.x + m[1].z * p.y + m[2].z * p.z + m[3].z,
+			m[0].w * p.x + m[1].w * p.y + m[2].w * p.z + m[3].w
+		};
+	}
+
+	dae::Vector3 TransformVector(const dae::Matrix& m, const dae::Vector3& v)
+	{
+		return dae::Vector3{
+			m[0].x * v.x + m[1].x * v.y + m[2].x * v.z,
+			m[0].y * v.x + m[1].y * v.y + m[2].y * v.z,
+			m[0].z * v.x + m[1].z * v.y + m[2].z * v.z
+		};
+	}
+}
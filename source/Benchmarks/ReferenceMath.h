@@ -0,0 +1,16 @@
+#pragma once
+#include "Math.h"
+
+namespace reference
+{
+	// The scalar math the headers replaced, defined out of line in ReferenceMath.cpp like the old Vector and Matrix sources,
+	// so every operation is a call the benchmark loops cannot inline. Sums are in the same order as the header versions
+	dae::Vector3 Add(const dae::Vector3& v1, const dae::Vector3& v2);
+	dae::Vector3 Scale(const dae::Vector3& v, float scale);
+	float Dot(const dae::Vector3& v1, const dae::Vector3& v2);
+	dae::Vector3 Normalized(const dae::Vector3& v);
+
+	dae::Matrix Multiply(const dae::Matrix& m1, const dae::Matrix& m2);
+	dae::Vector4 TransformPoint(const dae::Matrix& m, const dae::Vector4& p);
+	dae::Vector3 TransformVector(const dae::Matrix& m, const dae::Vector3& v);
+}
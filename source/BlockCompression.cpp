@@ -0,0 +1,462 @@
+#include "pch.h"
+#include "BlockCompression.h"
+#include "CpuFeatures.h"
+#include <cstring>
+#include <immintrin.h>
+
+using namespace dae;
+
+//RGB565 endpoints, expanded back to 8 bits per channel by repeating the high bits like the hardware does
+static uint16_t PackRGB565(const float (&colour)[3])
+{
+	const int r{ static_cast<int>((std::clamp(colour[0], 0.f, 255.f) * (31.f / 255.f)) + 0.5f) };
+	const int g{ static_cast<int>((std::clamp(colour[1], 0.f, 255.f) * (63.f / 255.f)) + 0.5f) };
+	const int b{ static_cast<int>((std::clamp(colour[2], 0.f, 255.f) * (31.f / 255.f)) + 0.5f) };
+
+	return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRGB565(uint16_t packed, int (&colour)[3])
+{
+	const int r{ (packed >> 11) & 31 };
+	const int g{ (packed >> 5) & 63 };
+	const int b{ packed & 31 };
+
+	colour[0] = (r << 3) | (r >> 2);
+	colour[1] = (g << 2) | (g >> 4);
+	colour[2] = (b << 3) | (b >> 2);
+}
+
+//four colours when the first endpoint is the larger one, otherwise three and black
+static void BuildBC1Palette(uint16_t colour0, uint16_t colour1, int (&palette)[4][3])
+{
+	UnpackRGB565(colour0, palette[0]);
+	UnpackRGB565(colour1, palette[1]);
+
+	for (int channel{ 0 }; channel < 3; ++channel)
+	{
+		if (colour0 > colour1)
+		{
+			palette[2][channel] = ((2 * palette[0][channel]) + palette[1][channel] + 1) / 3;
+			palette[3][channel] = (palette[0][channel] + (2 * palette[1][channel]) + 1) / 3;
+		}
+		else
+		{
+			palette[2][channel] = (palette[0][channel] + palette[1][channel] + 1) / 2;
+			palette[3][channel] = 0;
+		}
+	}
+}
+
+//orders the endpoints for four colour mode and picks the nearest palette colour per texel, returns the summed squared error
+static int FitBC1Indices(const int (&colours)[BlockCompression::m_TexelsPerBlock][3], uint16_t& colour0, uint16_t& colour1, uint8_t (&indices)[BlockCompression::m_TexelsPerBlock])
+{
+	if (colour0 < colour1)
+	{
+		std::swap(colour0, colour1);
+	}
+
+	int palette[4][3]{};
+	BuildBC1Palette(colour0, colour1, palette);
+
+	//equal endpoints are three colour mode, where only the first entry is the endpoint colour
+	const int amountOfCandidates{ colour0 == colour1 ? 1 : 4 };
+
+	int totalError{};
+	for (int texelIdx{ 0 }; texelIdx < BlockCompression::m_TexelsPerBlock; ++texelIdx)
+	{
+		int bestError{ INT_MAX };
+		for (int candidate{ 0 }; candidate < amountOfCandidates; ++candidate)
+		{
+			int error{};
+			for (int channel{ 0 }; channel < 3; ++channel)
+			{
+				const int difference{ colours[texelIdx][channel] - palette[candidate][channel] };
+				error += difference * difference;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				indices[texelIdx] = static_cast<uint8_t>(candidate);
+			}
+		}
+
+		totalError += bestError;
+	}
+
+	return totalError;
+}
+
+//eight interpolated values when the first endpoint is the larger one, otherwise six plus 0 and 255
+static void BuildBC4Palette(int value0, int value1, int (&palette)[8])
+{
+	palette[0] = value0;
+	palette[1] = value1;
+
+	if (value0 > value1)
+	{
+		for (int step{ 1 }; step < 7; ++step)
+		{
+			palette[step + 1] = (((7 - step) * value0) + (step * value1) + 3) / 7;
+		}
+	}
+	else
+	{
+		for (int step{ 1 }; step < 5; ++step)
+		{
+			palette[step + 1] = (((5 - step) * value0) + (step * value1) + 2) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+void BlockCompression::EncodeBC1Block(const uint32_t (&texels)[m_TexelsPerBlock], uint8_t* pBlock)
+{
+	int colours[m_TexelsPerBlock][3]{};
+	float mean[3]{};
+
+	for (int texelIdx{ 0 }; texelIdx < m_TexelsPerBlock; ++texelIdx)
+	{
+		for (int channel{ 0 }; channel < 3; ++channel)
+		{
+			colours[texelIdx][channel] = (texels[texelIdx] >> (channel * 8)) & 0xFF;
+			mean[channel] += colours[texelIdx][channel] / static_cast<float>(m_TexelsPerBlock);
+		}
+	}
+
+	//principal axis of the colours, by power iteration on their covariance
+	float covariance[3][3]{};
+	for (int texelIdx{ 0 }; texelIdx < m_TexelsPerBlock; ++texelIdx)
+	{
+		for (int row{ 0 }; row < 3; ++row)
+		{
+			for (int column{ 0 }; column < 3; ++column)
+			{
+				covariance[row][column] += (colours[texelIdx][row] - mean[row]) * (colours[texelIdx][column] - mean[column]);
+			}
+		}
+	}
+
+	float axis[3]{ 1.f, 1.f, 1.f };
+	for (int iteration{ 0 }; iteration < 8; ++iteration)
+	{
+		float next[3]{};
+		for (int row{ 0 }; row < 3; ++row)
+		{
+			next[row] = (covariance[row][0] * axis[0]) + (covariance[row][1] * axis[1]) + (covariance[row][2] * axis[2]);
+		}
+
+		//a block of a single colour has no axis, any direction works
+		const float largest{ std::max({ std::abs(next[0]), std::abs(next[1]), std::abs(next[2]) }) };
+		if (largest < 1e-4f)
+		{
+			break;
+		}
+
+		for (int channel{ 0 }; channel < 3; ++channel)
+		{
+			axis[channel] = next[channel] / largest;
+		}
+	}
+
+	const float axisLength{ sqrtf((axis[0] * axis[0]) + (axis[1] * axis[1]) + (axis[2] * axis[2])) };
+	for (float& component : axis)
+	{
+		component /= axisLength;
+	}
+
+	//the extreme projections span the endpoints, pulled in by a sixteenth so outliers do not stretch the palette
+	float minProjection{ FLT_MAX };
+	float maxProjection{ -FLT_MAX };
+	for (int texelIdx{ 0 }; texelIdx < m_TexelsPerBlock; ++texelIdx)
+	{
+		float projection{};
+		for (int channel{ 0 }; channel < 3; ++channel)
+		{
+			projection += (colours[texelIdx][channel] - mean[channel]) * axis[channel];
+		}
+
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+
+	const float inset{ (maxProjection - minProjection) / 16.f };
+	float endpoint0[3]{};
+	float endpoint1[3]{};
+	for (int channel{ 0 }; channel < 3; ++channel)
+	{
+		endpoint0[channel] = mean[channel] + (axis[channel] * (maxProjection - inset));
+		endpoint1[channel] = mean[channel] + (axis[channel] * (minProjection + inset));
+	}
+
+	uint16_t colour0{ PackRGB565(endpoint0) };
+	uint16_t colour1{ PackRGB565(endpoint1) };
+	uint8_t indices[m_TexelsPerBlock]{};
+	int error{ FitBC1Indices(colours, colour0, colour1, indices) };
+
+	//one least squares pass moves the endpoints to the best fit for the indices that were picked
+	if (colour0 != colour1)
+	{
+		constexpr float weights[4]{ 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+
+		float weight00{};
+		float weight01{};
+		float weight11{};
+		float weightedColour0[3]{};
+		float weightedColour1[3]{};
+
+		for (int texelIdx{ 0 }; texelIdx < m_TexelsPerBlock; ++texelIdx)
+		{
+			const float weight0{ weights[indices[texelIdx]] };
+			const float weight1{ 1.f - weight0 };
+
+			weight00 += weight0 * weight0;
+			weight01 += weight0 * weight1;
+			weight11 += weight1 * weight1;
+
+			for (int channel{ 0 }; channel < 3; ++channel)
+			{
+				weightedColour0[channel] += weight0 * colours[texelIdx][channel];
+				weightedColour1[channel] += weight1 * colours[texelIdx][channel];
+			}
+		}
+
+		const float determinant{ (weight00 * weight11) - (weight01 * weight01) };
+		if (std::abs(determinant) > 1e-4f)
+		{
+			for (int channel{ 0 }; channel < 3; ++channel)
+			{
+				endpoint0[channel] = ((weight11 * weightedColour0[channel]) - (weight01 * weightedColour1[channel])) / determinant;
+				endpoint1[channel] = ((weight00 * weightedColour1[channel]) - (weight01 * weightedColour0[channel])) / determinant;
+			}
+
+			uint16_t refinedColour0{ PackRGB565(endpoint0) };
+			uint16_t refinedColour1{ PackRGB565(endpoint1) };
+			uint8_t refinedIndices[m_TexelsPerBlock]{};
+			const int refinedError{ FitBC1Indices(colours, refinedColour0, refinedColour1, refinedIndices) };
+
+			if (refinedError < error)
+			{
+				error = refinedError;
+				colour0 = refinedColour0;
+				colour1 = refinedColour1;
+				std::copy_n(refinedIndices, m_TexelsPerBlock, indices);
+			}
+		}
+	}
+
+	uint32_t packedIndices{};
+	for (int texelIdx{ 0 }; texelIdx < m_TexelsPerBlock; ++texelIdx)
+	{
+		packedIndices |= static_cast<uint32_t>(indices[texelIdx]) << (texelIdx * 2);
+	}
+
+	//little endian, like the GPU reads it
+	std::memcpy(pBlock, &colour0, sizeof(colour0));
+	std::memcpy(pBlock + 2, &colour1, sizeof(colour1));
+	std::memcpy(pBlock + 4, &packedIndices, sizeof(packedIndices));
+}
+
+void BlockCompression::EncodeBC4Block(const uint8_t (&values)[m_TexelsPerBlock], uint8_t* pBlock)
+{
+	//eight value mode between the extremes, a flat block keeps every index on the first endpoint
+	const auto [pMinValue, pMaxValue] { std::minmax_element(std::begin(values), std::end(values)) };
+	const int value0{ *pMaxValue };
+	const int value1{ *pMinValue };
+
+	int palette[8]{};
+	BuildBC4Palette(value0, value1, palette);
+
+	uint64_t packedIndices{};
+	if (value0 != value1)
+	{
+		for (int texelIdx{ 0 }; texelIdx < m_TexelsPerBlock; ++texelIdx)
+		{
+			int bestIndex{};
+			int bestError{ INT_MAX };
+
+			for (int candidate{ 0 }; candidate < 8; ++candidate)
+			{
+				const int error{ std::abs(values[texelIdx] - palette[candidate]) };
+				if (error < bestError)
+				{
+					bestError = error;
+					bestIndex = candidate;
+				}
+			}
+
+			packedIndices |= static_cast<uint64_t>(bestIndex) << (texelIdx * 3);
+		}
+	}
+
+	pBlock[0] = static_cast<uint8_t>(value0);
+	pBlock[1] = static_cast<uint8_t>(value1);
+	std::memcpy(pBlock + 2, &packedIndices, 6);
+}
+
+//decoders for the baseline instruction set, a palette lookup per texel gives the same bytes as the AVX2 decoders
+static void DecodeBC1BlockScalar(uint16_t colour0, uint16_t colour1, uint32_t packedIndices, uint8_t (&red)[BlockCompression::m_TexelsPerBlock], uint8_t (&green)[BlockCompression::m_TexelsPerBlock], uint8_t (&blue)[BlockCompression::m_TexelsPerBlock])
+{
+	int palette[4][3]{};
+	BuildBC1Palette(colour0, colour1, palette);
+
+	for (int texelIdx{ 0 }; texelIdx < BlockCompression::m_TexelsPerBlock; ++texelIdx)
+	{
+		const int* pColour{ palette[(packedIndices >> (texelIdx * 2)) & 0b11] };
+		red[texelIdx] = static_cast<uint8_t>(pColour[0]);
+		green[texelIdx] = static_cast<uint8_t>(pColour[1]);
+		blue[texelIdx] = static_cast<uint8_t>(pColour[2]);
+	}
+}
+
+static void DecodeBC4BlockScalar(int value0, int value1, uint64_t packedIndices, uint8_t (&values)[BlockCompression::m_TexelsPerBlock])
+{
+	int palette[8]{};
+	BuildBC4Palette(value0, value1, palette);
+
+	for (int texelIdx{ 0 }; texelIdx < BlockCompression::m_TexelsPerBlock; ++texelIdx)
+	{
+		values[texelIdx] = static_cast<uint8_t>(palette[(packedIndices >> (texelIdx * 3)) & 0b111]);
+	}
+}
+
+void BlockCompression::DecodeBC1Block(const uint8_t* pBlock, uint8_t (&red)[m_TexelsPerBlock], uint8_t (&green)[m_TexelsPerBlock], uint8_t (&blue)[m_TexelsPerBlock])
+{
+	//one load for the whole block, split in registers
+	uint64_t bits{};
+	std::memcpy(&bits, pBlock, sizeof(bits));
+	const uint16_t colour0{ static_cast<uint16_t>(bits) };
+	const uint16_t colour1{ static_cast<uint16_t>(bits >> 16) };
+	const uint32_t packedIndices{ static_cast<uint32_t>(bits >> 32) };
+
+	if (CpuFeatures::GetInstructionSet() == InstructionSet::baseline)
+	{
+		DecodeBC1BlockScalar(colour0, colour1, packedIndices, red, green, blue);
+		return;
+	}
+
+	//the same palette as BuildBC1Palette, four 16 bit entries per channel: (weight0 * endpoint0 + weight1 * endpoint1 + 1) / divisor,
+	//dividing by 3 or 2 as a multiply by 65536 / divisor, exact for these small sums
+	int endpoint0[3]{};
+	int endpoint1[3]{};
+	UnpackRGB565(colour0, endpoint0);
+	UnpackRGB565(colour1, endpoint1);
+
+	constexpr uint64_t fourTimes{ 0x0001000100010001ull };
+	const __m256i endpoints0{ _mm256_setr_epi64x(endpoint0[0] * fourTimes, endpoint0[1] * fourTimes, endpoint0[2] * fourTimes, 0) };
+	const __m256i endpoints1{ _mm256_setr_epi64x(endpoint1[0] * fourTimes, endpoint1[1] * fourTimes, endpoint1[2] * fourTimes, 0) };
+
+	const bool isFourColours{ colour0 > colour1 };
+	const __m256i weights0{ isFourColours ? _mm256_setr_epi16(3, 0, 2, 1, 3, 0, 2, 1, 3, 0, 2, 1, 0, 0, 0, 0) : _mm256_setr_epi16(2, 0, 1, 0, 2, 0, 1, 0, 2, 0, 1, 0, 0, 0, 0, 0) };
+	const __m256i weights1{ isFourColours ? _mm256_setr_epi16(0, 3, 1, 2, 0, 3, 1, 2, 0, 3, 1, 2, 0, 0, 0, 0) : _mm256_setr_epi16(0, 2, 1, 0, 0, 2, 1, 0, 0, 2, 1, 0, 0, 0, 0, 0) };
+	const __m256i reciprocal{ _mm256_set1_epi16(static_cast<short>(isFourColours ? 21846 : 32768)) };
+
+	const __m256i sums{ _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(weights0, endpoints0), _mm256_mullo_epi16(weights1, endpoints1)), _mm256_set1_epi16(1)) };
+	const __m256i entries{ _mm256_mulhi_epu16(sums, reciprocal) };
+	const __m128i palette{ _mm_packus_epi16(_mm256_castsi256_si128(entries), _mm256_extracti128_si256(entries, 1)) };
+
+	//every texel's 2 bit index shifted into its own 32 bit lane, then narrowed to bytes in texel order
+	const __m256i shifts{ _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14) };
+	const __m256i mask{ _mm256_set1_epi32(0b11) };
+	const __m256i firstRows{ _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(packedIndices & 0xFFFF)), shifts), mask) };
+	const __m256i lastRows{ _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(packedIndices >> 16)), shifts), mask) };
+	const __m256i words{ _mm256_permute4x64_epi64(_mm256_packus_epi32(firstRows, lastRows), 0b11011000) };
+	const __m128i indices{ _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1)) };
+
+	//the palette holds red, green and blue entries one after the other
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(red), _mm_shuffle_epi8(palette, indices));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(green), _mm_shuffle_epi8(palette, _mm_add_epi8(indices, _mm_set1_epi8(4))));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(blue), _mm_shuffle_epi8(palette, _mm_add_epi8(indices, _mm_set1_epi8(8))));
+}
+
+void BlockCompression::DecodeBC4Block(const uint8_t* pBlock, uint8_t (&values)[m_TexelsPerBlock])
+{
+	//the indices are the top 48 bits of the block
+	uint64_t packedIndices{};
+	std::memcpy(&packedIndices, pBlock, sizeof(packedIndices));
+	packedIndices >>= 16;
+
+	if (CpuFeatures::GetInstructionSet() == InstructionSet::baseline)
+	{
+		DecodeBC4BlockScalar(pBlock[0], pBlock[1], packedIndices, values);
+		return;
+	}
+
+	//the same palette as BuildBC4Palette, (weight0 * value0 + weight1 * value1 + divisor / 2) / divisor with the division
+	//by 7 or 5 as a multiply by 65536 / divisor, exact for these small sums. Six value mode adds 0 and 255
+	const __m128i value0{ _mm_set1_epi16(pBlock[0]) };
+	const __m128i value1{ _mm_set1_epi16(pBlock[1]) };
+
+	__m128i palette{};
+	if (pBlock[0] > pBlock[1])
+	{
+		const __m128i sums{ _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_setr_epi16(7, 0, 6, 5, 4, 3, 2, 1), value0),
+			_mm_mullo_epi16(_mm_setr_epi16(0, 7, 1, 2, 3, 4, 5, 6), value1)), _mm_set1_epi16(3)) };
+		palette = _mm_mulhi_epu16(sums, _mm_set1_epi16(9363));
+	}
+	else
+	{
+		const __m128i sums{ _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_setr_epi16(5, 0, 4, 3, 2, 1, 0, 0), value0),
+			_mm_mullo_epi16(_mm_setr_epi16(0, 5, 1, 2, 3, 4, 0, 0), value1)), _mm_set1_epi16(2)) };
+		palette = _mm_or_si128(_mm_mulhi_epu16(sums, _mm_set1_epi16(13108)), _mm_setr_epi16(0, 0, 0, 0, 0, 0, 0, 255));
+	}
+
+	//every texel's 3 bit index shifted into its own 32 bit lane, then narrowed to bytes in texel order
+	const __m256i shifts{ _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21) };
+	const __m256i mask{ _mm256_set1_epi32(0b111) };
+	const __m256i firstHalf{ _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(packedIndices & 0xFFFFFF)), shifts), mask) };
+	const __m256i lastHalf{ _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(packedIndices >> 24)), shifts), mask) };
+	const __m256i words{ _mm256_permute4x64_epi64(_mm256_packus_epi32(firstHalf, lastHalf), 0b11011000) };
+	const __m128i indices{ _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1)) };
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(values), _mm_shuffle_epi8(_mm_packus_epi16(palette, palette), indices));
+}
+
+void BlockCompression::InterleavePlanes(const uint8_t (&planes)[4][m_TexelsPerBlock], uint8_t* pTexels)
+{
+	//a 4x16 byte transpose: bytes of plane pairs first, then the pairs
+	const __m128i plane0{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[0])) };
+	const __m128i plane1{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[1])) };
+	const __m128i plane2{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[2])) };
+	const __m128i plane3{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[3])) };
+
+	const __m128i pairs01Low{ _mm_unpacklo_epi8(plane0, plane1) };
+	const __m128i pairs01High{ _mm_unpackhi_epi8(plane0, plane1) };
+	const __m128i pairs23Low{ _mm_unpacklo_epi8(plane2, plane3) };
+	const __m128i pairs23High{ _mm_unpackhi_epi8(plane2, plane3) };
+
+	__m128i* pDestination{ reinterpret_cast<__m128i*>(pTexels) };
+	_mm_storeu_si128(pDestination + 0, _mm_unpacklo_epi16(pairs01Low, pairs23Low));
+	_mm_storeu_si128(pDestination + 1, _mm_unpackhi_epi16(pairs01Low, pairs23Low));
+	_mm_storeu_si128(pDestination + 2, _mm_unpacklo_epi16(pairs01High, pairs23High));
+	_mm_storeu_si128(pDestination + 3, _mm_unpackhi_epi16(pairs01High, pairs23High));
+}
+
+void BlockCompression::InterleavePlanes(const uint8_t (&planes)[8][m_TexelsPerBlock], uint8_t* pTexels)
+{
+	//an 8x16 byte transpose: bytes of plane pairs, then pairs of pairs, then the two halves of every texel
+	__m128i pairs[4][2]{};
+	for (int pairIdx{ 0 }; pairIdx < 4; ++pairIdx)
+	{
+		const __m128i evenPlane{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[pairIdx * 2])) };
+		const __m128i oddPlane{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[(pairIdx * 2) + 1])) };
+		pairs[pairIdx][0] = _mm_unpacklo_epi8(evenPlane, oddPlane);
+		pairs[pairIdx][1] = _mm_unpackhi_epi8(evenPlane, oddPlane);
+	}
+
+	__m128i* pDestination{ reinterpret_cast<__m128i*>(pTexels) };
+	for (int half{ 0 }; half < 2; ++half)
+	{
+		const __m128i quads0123Low{ _mm_unpacklo_epi16(pairs[0][half], pairs[1][half]) };
+		const __m128i quads0123High{ _mm_unpackhi_epi16(pairs[0][half], pairs[1][half]) };
+		const __m128i quads4567Low{ _mm_unpacklo_epi16(pairs[2][half], pairs[3][half]) };
+		const __m128i quads4567High{ _mm_unpackhi_epi16(pairs[2][half], pairs[3][half]) };
+
+		_mm_storeu_si128(pDestination + (half * 4) + 0, _mm_unpacklo_epi32(quads0123Low, quads4567Low));
+		_mm_storeu_si128(pDestination + (half * 4) + 1, _mm_unpackhi_epi32(quads0123Low, quads4567Low));
+		_mm_storeu_si128(pDestination + (half * 4) + 2, _mm_unpacklo_epi32(quads0123High, quads4567High));
+		_mm_storeu_si128(pDestination + (half * 4) + 3, _mm_unpackhi_epi32(quads0123High, quads4567High));
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace dae
+{
+	// Encoders and decoders for the 4x4 block formats textures are stored in, the texels of a block go row by row.
+	// BC1 holds RGB in 8 bytes and BC4 a single channel in 8 bytes, BC3 is a BC4 alpha block followed by a BC1 colour block
+	// and BC5 is two BC4 blocks, red then green
+	class BlockCompression final
+	{
+	public:
+		// CONSTANTS
+		static constexpr int m_BlockSize{ 4 };
+		static constexpr int m_TexelsPerBlock{ m_BlockSize * m_BlockSize };
+		static constexpr int m_BC1BlockBytes{ 8 };
+		static constexpr int m_BC4BlockBytes{ 8 };
+
+		// MEMBER FUNCTIONS
+		//texels are RGBA8 with red in the lowest byte, alpha is ignored
+		static void EncodeBC1Block(const uint32_t (&texels)[m_TexelsPerBlock], uint8_t* pBlock);
+		static void EncodeBC4Block(const uint8_t (&values)[m_TexelsPerBlock], uint8_t* pBlock);
+
+		//decoders write planes, one byte per texel
+		static void DecodeBC1Block(const uint8_t* pBlock, uint8_t (&red)[m_TexelsPerBlock], uint8_t (&green)[m_TexelsPerBlock], uint8_t (&blue)[m_TexelsPerBlock]);
+		static void DecodeBC4Block(const uint8_t* pBlock, uint8_t (&values)[m_TexelsPerBlock]);
+
+		//texel i of the result is byte i of every plane in turn, 4 or 8 bytes per texel
+		static void InterleavePlanes(const uint8_t (&planes)[4][m_TexelsPerBlock], uint8_t* pTexels);
+		static void InterleavePlanes(const uint8_t (&planes)[8][m_TexelsPerBlock], uint8_t* pTexels);
+	};
+}
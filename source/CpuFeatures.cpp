@@ -0,0 +1,92 @@
+#include "pch.h"
+#include "CpuFeatures.h"
+#include <intrin.h>
+#include <immintrin.h>
+
+using namespace dae;
+
+static bool HasBits(int value, std::initializer_list<int> bits)
+{
+	for (const int bit : bits)
+	{
+		if ((value & (1 << bit)) == 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static InstructionSet DetectInstructionSet()
+{
+	//eax, ebx, ecx, edx
+	int registers[4]{};
+
+	__cpuid(registers, 0);
+	if (registers[0] < 7)
+	{
+		return InstructionSet::baseline;
+	}
+
+	//FMA, OSXSAVE and AVX
+	__cpuid(registers, 1);
+	if (!HasBits(registers[2], { 12, 27, 28 }))
+	{
+		return InstructionSet::baseline;
+	}
+
+	//the OS has to save the XMM and YMM registers, and for AVX-512 the opmask and ZMM registers too
+	const unsigned long long enabledStates{ _xgetbv(0) };
+	if ((enabledStates & 0x6) != 0x6)
+	{
+		return InstructionSet::baseline;
+	}
+
+	//AVX2, then AVX512F, AVX512DQ, AVX512BW and AVX512VL
+	__cpuidex(registers, 7, 0);
+	if (!HasBits(registers[1], { 5 }))
+	{
+		return InstructionSet::baseline;
+	}
+
+	if (!HasBits(registers[1], { 16, 17, 30, 31 }) || (enabledStates & 0xE6) != 0xE6)
+	{
+		return InstructionSet::avx2;
+	}
+
+	return InstructionSet::avx512;
+}
+
+InstructionSet CpuFeatures::GetSupportedInstructionSet()
+{
+	static const InstructionSet supported{ DetectInstructionSet() };
+	return supported;
+}
+
+InstructionSet CpuFeatures::SelectInstructionSet(InstructionSet requested)
+{
+	m_InstructionSet = std::min(requested, GetSupportedInstructionSet());
+	return m_InstructionSet;
+}
+
+InstructionSet CpuFeatures::GetInstructionSet()
+{
+	return m_InstructionSet;
+}
+
+bool CpuFeatures::ParseInstructionSet(const std::string& name, InstructionSet& instructionSet)
+{
+	constexpr const char* names[]{ "baseline", "avx2", "avx512" };
+
+	for (int idx{ 0 }; idx < static_cast<int>(std::size(names)); ++idx)
+	{
+		if (name == names[idx])
+		{
+			instructionSet = static_cast<InstructionSet>(idx);
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+namespace dae
+{
+	// The levels the software kernels are built for. Baseline is what every x64 CPU has and runs the scalar kernels,
+	// AVX2 comes with FMA and AVX-512 is the F, DQ, BW and VL subsets together
+	enum class InstructionSet
+	{
+		baseline,
+		avx2,
+		avx512
+	};
+
+	inline const char* GetInstructionSetName(InstructionSet instructionSet)
+	{
+		constexpr const char* names[]{ "BASELINE (SSE2)", "AVX2", "AVX-512" };
+		return names[static_cast<int>(instructionSet)];
+	}
+
+	// Finds out once what the CPU and the OS support and holds the level every kernel dispatches on for the rest of the process.
+	// The renderer selects it when it is constructed, before any texture is loaded or anything is rasterized
+	class CpuFeatures final
+	{
+	public:
+		// MEMBER FUNCTIONS
+		//highest level the CPU has and the OS saves the registers of on a context switch
+		static InstructionSet GetSupportedInstructionSet();
+
+		//a level above the supported one is lowered to it, returns the level that is active afterwards
+		static InstructionSet SelectInstructionSet(InstructionSet requested);
+		static InstructionSet GetInstructionSet();
+
+		//"baseline", "avx2" or "avx512", false for anything else
+		static bool ParseInstructionSet(const std::string& name, InstructionSet& instructionSet);
+
+	private:
+		// MEMBER VARIABLES
+		//nothing above the baseline runs until a level is selected
+		inline static InstructionSet m_InstructionSet{ InstructionSet::baseline };
+	};
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "BlockCompression.h"
+
+namespace dae
+{
+	// Small direct mapped cache of decoded 4x4 blocks, meant to live once per thread so lookups never lock.
+	// Entries are tagged with the texture they belong to, so one cache serves every texture with the same texel type
+	template<typename Texel, int AmountOfEntries = 64>
+	class DecodedBlockCache final
+	{
+	public:
+		// MEMBER FUNCTIONS
+		//returns the decoded texels of the block, calling decodeBlock(blockIdx, texels) on a miss
+		template<typename Decoder>
+		const Texel* GetBlock(const void* pOwner, int blockIdx, const Decoder& decodeBlock)
+		{
+			//fibonacci hashing, so the blocks above and below one do not fight over the same entry
+			Entry& entry{ m_Entries[(static_cast<uint32_t>(blockIdx) * 2654435769u) >> (32 - m_IndexBits)] };
+
+			if (entry.blockIdx != blockIdx || entry.pOwner != pOwner)
+			{
+				decodeBlock(blockIdx, entry.texels);
+				entry.pOwner = pOwner;
+				entry.blockIdx = blockIdx;
+			}
+
+			return entry.texels;
+		}
+
+	private:
+		// CONSTANTS
+		static_assert(std::has_single_bit(static_cast<unsigned int>(AmountOfEntries)), "the entry count is a power of two");
+		static constexpr int m_IndexBits{ std::bit_width(static_cast<unsigned int>(AmountOfEntries)) - 1 };
+
+		// STRUCTS
+		struct Entry
+		{
+			const void* pOwner{ nullptr };
+			int blockIdx{ -1 };
+			Texel texels[BlockCompression::m_TexelsPerBlock]{};
+		};
+
+		// MEMBER VARIABLES
+		Entry m_Entries[AmountOfEntries]{};
+	};
+}
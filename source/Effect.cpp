@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Effect.h"
+#include "MipChain.h"
 
 using namespace dae;
 
@@ -149,6 +150,7 @@ void Effect::CreateSamplerState(ID3D11Device* pDevice)
 	}
 
 	samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
+	samplerDesc.MaxAnisotropy = MipChain::m_MaxAnisotropy;
 	result = pDevice->CreateSamplerState(&samplerDesc, &m_pAnisotropicState);
 
 	if (FAILED(result))
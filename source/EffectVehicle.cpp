@@ -31,6 +31,12 @@ EffectVehicle::EffectVehicle(ID3D11Device* pDevice, const std::wstring& assetFil
 		std::wcout << L"NormalMapVariable not valid\n";
 	}
 
+	m_pNormalRotationsVariable = m_pEffect->GetVariableByName("gNormalRotations")->AsShaderResource();
+	if (!m_pNormalRotationsVariable->IsValid())
+	{
+		std::wcout << L"NormalRotationsVariable not valid\n";
+	}
+
 	m_pIsNormalMapOn = m_pEffect->GetVariableByName("gUseNormals")->AsScalar();
 	if (!m_pIsNormalMapOn->IsValid())
 	{
@@ -46,6 +52,7 @@ EffectVehicle::~EffectVehicle()
 	m_pSpecularMapVariable->Release();
 	m_pGlossinessMapVariable->Release();
 	m_pNormalMapVariable->Release();
+	m_pNormalRotationsVariable->Release();
 
 	if (m_pIsNormalMapOn != nullptr)
 	{
@@ -85,6 +92,14 @@ void EffectVehicle::SetNormalMap(Texture* pNormalTexture)
 	}
 }
 
+void EffectVehicle::SetNormalRotations(ID3D11ShaderResourceView* pNormalRotations)
+{
+	if (m_pNormalRotationsVariable)
+	{
+		m_pNormalRotationsVariable->SetResource(pNormalRotations);
+	}
+}
+
 void EffectVehicle::ToggleNormalMap()
 {
 	m_IsUsingNormal = !m_IsUsingNormal;
@@ -24,6 +24,7 @@ namespace dae
 		void SetSpecularMap(Texture* pSpecularTexture);
 		void SetGlossinessMap(Texture* pGlossTexture);
 		void SetNormalMap(Texture* pNormalTexture);
+		void SetNormalRotations(ID3D11ShaderResourceView* pNormalRotations);
 		void ToggleNormalMap();
 
 	private:
@@ -32,6 +33,7 @@ namespace dae
 		ID3DX11EffectShaderResourceVariable* m_pSpecularMapVariable;
 		ID3DX11EffectShaderResourceVariable* m_pGlossinessMapVariable; 
 		ID3DX11EffectShaderResourceVariable* m_pNormalMapVariable;
+		ID3DX11EffectShaderResourceVariable* m_pNormalRotationsVariable;
 
 		ID3DX11EffectScalarVariable* m_pIsNormalMapOn;
 	};
@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "FrameArena.h"
+
+using namespace dae;
+
+FrameArena::FrameArena(size_t capacity) :
+	m_pBlock{ NewBlock(capacity) },
+	m_Capacity{ capacity }
+{
+}
+
+FrameArena::~FrameArena()
+{
+	for (uint8_t* pOverflowBlock : m_pOverflowBlocks)
+	{
+		DeleteBlock(pOverflowBlock);
+	}
+
+	DeleteBlock(m_pBlock);
+}
+
+void FrameArena::Reset()
+{
+	if (!m_pOverflowBlocks.empty())
+	{
+		for (uint8_t* pOverflowBlock : m_pOverflowBlocks)
+		{
+			DeleteBlock(pOverflowBlock);
+		}
+		m_pOverflowBlocks.clear();
+
+		//the same frame again fits in the block without any overflow, with room for frames that are a bit bigger
+		DeleteBlock(m_pBlock);
+		m_Capacity = GetUsedBytes() + (GetUsedBytes() / 4);
+		m_pBlock = NewBlock(m_Capacity);
+		m_OverflowBytes = 0;
+	}
+
+	m_Offset = 0;
+}
+
+size_t FrameArena::GetCapacity() const
+{
+	return m_Capacity;
+}
+
+size_t FrameArena::GetUsedBytes() const
+{
+	return m_Offset + m_OverflowBytes;
+}
+
+void* FrameArena::AllocateBytes(size_t bytes, size_t alignment)
+{
+	const size_t begin{ (m_Offset + alignment - 1) & ~(alignment - 1) };
+	if (begin + bytes <= m_Capacity)
+	{
+		m_Offset = begin + bytes;
+		return m_pBlock + begin;
+	}
+
+	//counted with the worst case padding, so the grown block is never too small for the same allocations
+	uint8_t* pOverflowBlock{ NewBlock(bytes) };
+	m_pOverflowBlocks.push_back(pOverflowBlock);
+	m_OverflowBytes += bytes + alignment;
+
+	return pOverflowBlock;
+}
+
+uint8_t* FrameArena::NewBlock(size_t bytes)
+{
+	return static_cast<uint8_t*>(::operator new(bytes, std::align_val_t{ m_BlockAlignment }));
+}
+
+void FrameArena::DeleteBlock(uint8_t* pBlock)
+{
+	::operator delete(pBlock, std::align_val_t{ m_BlockAlignment });
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+namespace dae
+{
+	// Linear allocator for the transient data of one rasterized software frame: post-transform vertices, normal matrices,
+	// triangle setups and tile bins. Allocating moves an offset and a reset moves it back, nothing is freed on its own.
+	// What does not fit goes to overflow blocks, the next reset swaps everything for one block with room for that frame and a
+	// quarter more, so once the frames stop growing they never touch the heap
+	class FrameArena final
+	{
+	public:
+		// CONSTRUCTOR AND DESTRUCTOR
+		explicit FrameArena(size_t capacity);
+		~FrameArena();
+
+		// RULE OF FIVE
+		FrameArena(const FrameArena& other) = delete;
+		FrameArena& operator=(const FrameArena& other) = delete;
+		FrameArena(FrameArena&& other) noexcept = delete;
+		FrameArena& operator=(FrameArena&& other) noexcept = delete;
+
+		// MEMBER FUNCTIONS
+		//the elements are not initialized and never destroyed, every element has to be written before it is read
+		template<typename T>
+		std::span<T> Allocate(size_t count)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "the arena never runs destructors");
+			static_assert(alignof(T) <= m_BlockAlignment, "blocks are only aligned to a cache line");
+
+			return { static_cast<T*>(AllocateBytes(count * sizeof(T), alignof(T))), count };
+		}
+
+		//everything allocated since the last reset is invalid afterwards
+		void Reset();
+
+		size_t GetCapacity() const;
+		size_t GetUsedBytes() const;
+
+	private:
+		// CONSTANTS
+		static constexpr size_t m_BlockAlignment{ 64 };
+
+		// MEMBER VARIABLES
+		uint8_t* m_pBlock;
+		size_t m_Capacity;
+		size_t m_Offset{};
+
+		//allocations that did not fit, each in its own block until the next reset
+		std::vector<uint8_t*> m_pOverflowBlocks{};
+		size_t m_OverflowBytes{};
+
+		// MEMBER FUNCTIONS
+		void* AllocateBytes(size_t bytes, size_t alignment);
+
+		static uint8_t* NewBlock(size_t bytes);
+		static void DeleteBlock(uint8_t* pBlock);
+	};
+}
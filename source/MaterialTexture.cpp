@@ -0,0 +1,106 @@
+#include "pch.h"
+#include "MaterialTexture.h"
+#include "Texture.h"
+#include "DecodedBlockCache.h"
+#include "NormalMapBaker.h"
+#include "AllocationTracker.h"
+#include <cassert>
+#include <cstring>
+
+using namespace dae;
+
+MaterialTexture::MaterialTexture(const Texture* pDiffuseTexture, const Texture* pSpecularTexture, const Texture* pGlossinessTexture, const Texture* pNormalTexture) :
+	m_MipChain{ pDiffuseTexture->GetWidth(), pDiffuseTexture->GetHeight() }
+{
+	const AllocationTracker::Scope allocationScope{ Subsystem::texture };
+
+	//All maps share the uv layout and have to share the resolution as well, so their blocks line up
+	const int width{ pDiffuseTexture->GetWidth() };
+	const int height{ pDiffuseTexture->GetHeight() };
+	assert(pSpecularTexture->GetWidth() == width && pSpecularTexture->GetHeight() == height);
+	assert(pGlossinessTexture->GetWidth() == width && pGlossinessTexture->GetHeight() == height);
+	assert(pNormalTexture->GetWidth() == width && pNormalTexture->GetHeight() == height);
+
+	assert(pDiffuseTexture->GetFormat() == TextureFormat::bc1);
+	assert(pSpecularTexture->GetFormat() == TextureFormat::bc4);
+	assert(pGlossinessTexture->GetFormat() == TextureFormat::bc4);
+	assert(pNormalTexture->GetFormat() == TextureFormat::rg16);
+
+	m_pBlocks = new MaterialBlock[m_MipChain.GetAmountOfBlocks()]{};
+
+	//the maps are already filtered and compressed per level, interleaving needs no re-encoding
+	for (int blockIdx{ 0 }; blockIdx < m_MipChain.GetAmountOfBlocks(); ++blockIdx)
+	{
+		MaterialBlock& block{ m_pBlocks[blockIdx] };
+		std::copy_n(pDiffuseTexture->GetBlock(blockIdx), sizeof(block.diffuse), block.diffuse);
+		std::copy_n(pSpecularTexture->GetBlock(blockIdx), sizeof(block.specular), block.specular);
+		std::copy_n(pGlossinessTexture->GetBlock(blockIdx), sizeof(block.glossiness), block.glossiness);
+		std::copy_n(pNormalTexture->GetBlock(blockIdx), sizeof(block.normal), block.normal);
+	}
+
+	//counted as one copy, the four maps are only split up per block
+	AllocationTracker::CountCopy(size_t(m_MipChain.GetAmountOfBlocks()) * sizeof(MaterialBlock));
+}
+
+MaterialTexture::~MaterialTexture()
+{
+	delete[] m_pBlocks;
+}
+
+void MaterialTexture::DecodeBlock(int blockIdx, MaterialTexel (&texels)[BlockCompression::m_TexelsPerBlock]) const
+{
+	//one plane per byte of the compressed part of the material texel, in the same order
+	const MaterialBlock& block{ m_pBlocks[blockIdx] };
+	constexpr int compressedBytes{ offsetof(MaterialTexel, normal) };
+	uint8_t planes[compressedBytes][BlockCompression::m_TexelsPerBlock]{};
+
+	BlockCompression::DecodeBC1Block(block.diffuse, planes[0], planes[1], planes[2]);
+	BlockCompression::DecodeBC4Block(block.specular, planes[3]);
+	BlockCompression::DecodeBC4Block(block.glossiness, planes[4]);
+
+	uint8_t compressedTexels[BlockCompression::m_TexelsPerBlock][compressedBytes]{};
+	BlockCompression::InterleavePlanes(planes, compressedTexels[0]);
+
+	//the normals are stored texel by texel already
+	for (int texelIdx{ 0 }; texelIdx < BlockCompression::m_TexelsPerBlock; ++texelIdx)
+	{
+		std::memcpy(&texels[texelIdx], compressedTexels[texelIdx], compressedBytes);
+		std::memcpy(texels[texelIdx].normal, block.normal + (texelIdx * sizeof(texels[texelIdx].normal)), sizeof(texels[texelIdx].normal));
+	}
+}
+
+MaterialTexture::MaterialSample MaterialTexture::Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, const SamplerDesc& sampler) const
+{
+	//blocks are decoded into a cache per thread, so neighbouring samples reuse them without locking
+	thread_local DecodedBlockCache<MaterialTexel> blockCache{};
+	DecodedBlockCache<MaterialTexel>& cache{ blockCache };
+
+	const auto fetchBlock = [this, &cache](int blockIdx)
+		{
+			const MaterialTexel* pTexels{ cache.GetBlock(this, blockIdx, [this](int idx, MaterialTexel (&texels)[BlockCompression::m_TexelsPerBlock]) { DecodeBlock(idx, texels); }) };
+			return reinterpret_cast<const uint8_t*>(pTexels);
+		};
+
+	float channels[sizeof(MaterialTexel)]{};
+	m_MipChain.Sample(fetchBlock, sampler, uv, uvDdx, uvDdy, channels);
+
+	constexpr float byteToFloat{ 1.f / 255.f };
+	constexpr float shortToFloat{ 1.f / 65535.f };
+
+	//both bytes of a 16 bit channel were filtered with the same weights, so they recombine into the filtered value
+	const float octahedralX{ (channels[8] + (channels[9] * 256.f)) * shortToFloat };
+	const float octahedralY{ (channels[10] + (channels[11] * 256.f)) * shortToFloat };
+
+	MaterialSample sample{};
+	sample.diffuse = ColorRGB{ channels[0] * byteToFloat, channels[1] * byteToFloat, channels[2] * byteToFloat };
+	sample.normal = NormalMapBaker::DecodeOctahedral(octahedralX, octahedralY);
+	sample.specular = channels[3] * byteToFloat;
+	sample.glossiness = channels[4] * byteToFloat;
+
+	return sample;
+}
+
+size_t MaterialTexture::GetCpuBytes() const
+{
+	return size_t(m_MipChain.GetAmountOfBlocks()) * sizeof(MaterialBlock);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "MipChain.h"
+
+namespace dae
+{
+	class Texture;
+
+	// Diffuse, specular, glossiness and normal map blocks interleaved into one 88 byte block for every mip level,
+	// decoded per block into 12 byte texels so the software shader fetches one record per sample instead of walking four textures
+	class MaterialTexture final
+	{
+	public:
+		// STRUCTS
+		struct MaterialSample
+		{
+			ColorRGB diffuse{};
+			Vector3 normal{};	//object space, not normalized
+			float specular{};
+			float glossiness{};
+		};
+
+		// CONSTRUCTOR AND DESTRUCTOR
+		MaterialTexture(const Texture* pDiffuseTexture, const Texture* pSpecularTexture, const Texture* pGlossinessTexture, const Texture* pNormalTexture);
+		~MaterialTexture();
+
+		// RULE OF FIVE
+		MaterialTexture(const MaterialTexture& other) = delete;
+		MaterialTexture& operator=(const MaterialTexture& other) = delete;
+		MaterialTexture(MaterialTexture&& other) noexcept = delete;
+		MaterialTexture& operator=(MaterialTexture&& other) noexcept = delete;
+
+		// MEMBER FUNCTIONS
+		MaterialSample Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, const SamplerDesc& sampler) const;
+
+		//only the software path samples it, so it never has a GPU copy
+		size_t GetCpuBytes() const;
+
+	private:
+		// STRUCTS
+		struct MaterialTexel
+		{
+			uint8_t diffuse[3]{};
+			uint8_t specular{};
+			uint8_t glossiness{};
+			uint8_t unused[3]{};
+			uint8_t normal[4]{};	//octahedral x and y, 16 bits each low byte first, filtering every byte on its own still adds up exactly
+		};
+		static_assert(sizeof(MaterialTexel) == 12, "a material texel is 12 bytes");
+
+		//the compressed blocks of the four maps side by side, copied as they are
+		struct MaterialBlock
+		{
+			uint8_t diffuse[BlockCompression::m_BC1BlockBytes]{};
+			uint8_t specular[BlockCompression::m_BC4BlockBytes]{};
+			uint8_t glossiness[BlockCompression::m_BC4BlockBytes]{};
+			uint8_t normal[BlockCompression::m_TexelsPerBlock * sizeof(uint32_t)]{};	//not compressed, octahedral x and y
+		};
+		static_assert(sizeof(MaterialBlock) == 88, "a material block is 88 bytes");
+
+		// MEMBER VARIABLES
+		MaterialBlock* m_pBlocks{ nullptr };
+		MipChain m_MipChain{};
+
+		// MEMBER FUNCTIONS
+		void DecodeBlock(int blockIdx, MaterialTexel (&texels)[BlockCompression::m_TexelsPerBlock]) const;
+	};
+}
@@ -1,7 +1,7 @@
-#pragma once
-#include "ColorRGB.h"
-#include "Vector2.h"
-#include "Vector3.h"
-#include "Vector4.h"
-#include "Matrix.h"
+#pragma once
+#include "ColorRGB.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Matrix.h"
 #include "MathHelpers.h"
\ No newline at end of file
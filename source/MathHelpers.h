@@ -1,59 +1,80 @@
-#pragma once
-#include <cmath>
-
-namespace dae
-{
-	/* --- HELPER STRUCTS --- */
-	struct Int2
-	{
-		int x{};
-		int y{};
-	};
-
-	/* --- CONSTANTS --- */
-	constexpr auto PI = 3.14159265358979323846f;
-	constexpr auto PI_DIV_2 = 1.57079632679489661923f;
-	constexpr auto PI_DIV_4 = 0.785398163397448309616f;
-	constexpr auto PI_2 = 6.283185307179586476925f;
-	constexpr auto PI_4 = 12.56637061435917295385f;
-
-	constexpr auto TO_DEGREES = (180.0f / PI);
-	constexpr auto TO_RADIANS(PI / 180.0f);
-
-	/* --- HELPER FUNCTIONS --- */
-	inline float Square(float a)
-	{
-		return a * a;
-	}
-
-	inline float Lerpf(float a, float b, float factor)
-	{
-		return ((1 - factor) * a) + (factor * b);
-	}
-
-	inline bool AreEqual(float a, float b, float epsilon = FLT_EPSILON)
-	{
-		return abs(a - b) < epsilon;
-	}
-
-	inline int Clamp(const int v, int min, int max)
-	{
-		if (v < min) return min;
-		if (v > max) return max;
-		return v;
-	}
-
-	inline float Clamp(const float v, float min, float max)
-	{
-		if (v < min) return min;
-		if (v > max) return max;
-		return v;
-	}
-
-	inline float Saturate(const float v)
-	{
-		if (v < 0.f) return 0.f;
-		if (v > 1.f) return 1.f;
-		return v;
-	}
+#pragma once
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <bit>
+#include <xmmintrin.h>
+
+namespace dae
+{
+	/* --- HELPER STRUCTS --- */
+	struct Int2
+	{
+		int x{};
+		int y{};
+	};
+
+	/* --- CONSTANTS --- */
+	constexpr auto PI = 3.14159265358979323846f;
+	constexpr auto PI_DIV_2 = 1.57079632679489661923f;
+	constexpr auto PI_DIV_4 = 0.785398163397448309616f;
+	constexpr auto PI_2 = 6.283185307179586476925f;
+	constexpr auto PI_4 = 12.56637061435917295385f;
+
+	constexpr auto TO_DEGREES = (180.0f / PI);
+	constexpr auto TO_RADIANS(PI / 180.0f);
+
+	/* --- HELPER FUNCTIONS --- */
+	inline float Square(float a)
+	{
+		return a * a;
+	}
+
+	inline float Lerpf(float a, float b, float factor)
+	{
+		return ((1 - factor) * a) + (factor * b);
+	}
+
+	inline bool AreEqual(float a, float b, float epsilon = FLT_EPSILON)
+	{
+		return abs(a - b) < epsilon;
+	}
+
+	inline int Clamp(const int v, int min, int max)
+	{
+		if (v < min) return min;
+		if (v > max) return max;
+		return v;
+	}
+
+	inline float Clamp(const float v, float min, float max)
+	{
+		if (v < min) return min;
+		if (v > max) return max;
+		return v;
+	}
+
+	inline float Saturate(const float v)
+	{
+		if (v < 0.f) return 0.f;
+		if (v > 1.f) return 1.f;
+		return v;
+	}
+
+	//the SSE estimate refined by one Newton-Raphson step, a few ulp from 1 / sqrtf(v) for normal positive values
+	inline float FastInverseSqrt(const float v)
+	{
+		const float estimate{ _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(v))) };
+		return estimate * (1.5f - (0.5f * v * estimate * estimate));
+	}
+
+	//log2 from the exponent bits and a quadratic fit of the mantissa, within 0.005 of std::log2 for positive values
+	inline float FastLog2(const float v)
+	{
+		const uint32_t bits{ std::bit_cast<uint32_t>(v) };
+		const float exponent{ static_cast<float>(static_cast<int>((bits >> 23) & 0xFF) - 128) };
+		const float mantissa{ std::bit_cast<float>((bits & 0x7FFFFF) | 0x3F800000) };
+
+		return exponent + (((-0.34484843f * mantissa) + 2.02466578f) * mantissa) - 0.67487759f;
+	}
 }
\ No newline at end of file
@@ -1,75 +1,391 @@
-#pragma once
-#include "Vector3.h"
-#include "Vector4.h"
-
-namespace dae {
-	struct Matrix
-	{
-		Matrix() = default;
-		Matrix(
-			const Vector3& xAxis,
-			const Vector3& yAxis,
-			const Vector3& zAxis,
-			const Vector3& t);
-
-		Matrix(
-			const Vector4& xAxis,
-			const Vector4& yAxis,
-			const Vector4& zAxis,
-			const Vector4& t);
-
-		Matrix(const Matrix& m);
-
-		Vector3 TransformVector(const Vector3& v) const;
-		Vector3 TransformVector(float x, float y, float z) const;
-		Vector3 TransformPoint(const Vector3& p) const;
-		Vector3 TransformPoint(float x, float y, float z) const;
-
-		Vector4 TransformPoint(const Vector4& p) const;
-		Vector4 TransformPoint(float x, float y, float z, float w) const;
-
-		const Matrix& Transpose();
-		const Matrix& Inverse();
-
-		Vector3 GetAxisX() const;
-		Vector3 GetAxisY() const;
-		Vector3 GetAxisZ() const;
-		Vector3 GetTranslation() const;
-
-		static Matrix CreateTranslation(float x, float y, float z);
-		static Matrix CreateTranslation(const Vector3& t);
-		static Matrix CreateRotationX(float pitch);
-		static Matrix CreateRotationY(float yaw);
-		static Matrix CreateRotationZ(float roll);
-		static Matrix CreateRotation(float pitch, float yaw, float roll);
-		static Matrix CreateRotation(const Vector3& r);
-		static Matrix CreateScale(float sx, float sy, float sz);
-		static Matrix CreateScale(const Vector3& s);
-		static Matrix Transpose(const Matrix& m);
-		static Matrix Inverse(const Matrix& m);
-
-		static Matrix CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up);
-		static Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf);
-
-		Vector4& operator[](int index);
-		Vector4 operator[](int index) const;
-		Matrix operator*(const Matrix& m) const;
-		const Matrix& operator*=(const Matrix& m);
-
-	private:
-
-		//Row-Major Matrix
-		Vector4 data[4]
-		{
-			{1,0,0,0}, //xAxis
-			{0,1,0,0}, //yAxis
-			{0,0,1,0}, //zAxis
-			{0,0,0,1}  //T
-		};
-
-		// v0x v0y v0z v0w
-		// v1x v1y v1z v1w
-		// v2x v2y v2z v2w
-		// v3x v3y v3z v3w
-	};
-}
\ No newline at end of file
+#pragma once
+#include "Vector3.h"
+#include "Vector4.h"
+#include "MathHelpers.h"
+#include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
+
+namespace dae {
+	struct Matrix
+	{
+		Matrix() = default;
+		Matrix(
+			const Vector3& xAxis,
+			const Vector3& yAxis,
+			const Vector3& zAxis,
+			const Vector3& t);
+
+		Matrix(
+			const Vector4& xAxis,
+			const Vector4& yAxis,
+			const Vector4& zAxis,
+			const Vector4& t);
+
+		Matrix(const Matrix& m);
+
+		Vector3 TransformVector(const Vector3& v) const;
+		Vector3 TransformVector(float x, float y, float z) const;
+		Vector3 TransformPoint(const Vector3& p) const;
+		Vector3 TransformPoint(float x, float y, float z) const;
+
+		Vector4 TransformPoint(const Vector4& p) const;
+		Vector4 TransformPoint(float x, float y, float z, float w) const;
+		//TransformPoint over an array of points, one SSE row per point. w of a Vector4 point is not read, like TransformPoint
+		void TransformPoints(const Vector3* pPoints, Vector4* pTransformed, size_t count) const;
+		void TransformPoints(const Vector4* pPoints, Vector4* pTransformed, size_t count) const;
+
+		const Matrix& Transpose();
+		const Matrix& Inverse();
+
+		Vector3 GetAxisX() const;
+		Vector3 GetAxisY() const;
+		Vector3 GetAxisZ() const;
+		Vector3 GetTranslation() const;
+
+		static Matrix CreateTranslation(float x, float y, float z);
+		static Matrix CreateTranslation(const Vector3& t);
+		static Matrix CreateRotationX(float pitch);
+		static Matrix CreateRotationY(float yaw);
+		static Matrix CreateRotationZ(float roll);
+		static Matrix CreateRotation(float pitch, float yaw, float roll);
+		static Matrix CreateRotation(const Vector3& r);
+		static Matrix CreateScale(float sx, float sy, float sz);
+		static Matrix CreateScale(const Vector3& s);
+		static Matrix Transpose(const Matrix& m);
+		static Matrix Inverse(const Matrix& m);
+
+		static Matrix CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up);
+		static Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf);
+
+		Vector4& operator[](int index);
+		Vector4 operator[](int index) const;
+		Matrix operator*(const Matrix& m) const;
+		const Matrix& operator*=(const Matrix& m);
+		bool operator==(const Matrix& m) const;
+
+	private:
+
+		//Row-Major Matrix
+		Vector4 data[4]
+		{
+			{1,0,0,0}, //xAxis
+			{0,1,0,0}, //yAxis
+			{0,0,1,0}, //zAxis
+			{0,0,0,1}  //T
+		};
+
+		// v0x v0y v0z v0w
+		// v1x v1y v1z v1w
+		// v2x v2y v2z v2w
+		// v3x v3y v3z v3w
+	};
+
+	inline Matrix::Matrix(const Vector3& xAxis, const Vector3& yAxis, const Vector3& zAxis, const Vector3& t) :
+		Matrix({ xAxis, 0 }, { yAxis, 0 }, { zAxis, 0 }, { t, 1 })
+	{
+	}
+
+	inline Matrix::Matrix(const Vector4& xAxis, const Vector4& yAxis, const Vector4& zAxis, const Vector4& t)
+	{
+		data[0] = xAxis;
+		data[1] = yAxis;
+		data[2] = zAxis;
+		data[3] = t;
+	}
+
+	inline Matrix::Matrix(const Matrix& m)
+	{
+		data[0] = m.data[0];
+		data[1] = m.data[1];
+		data[2] = m.data[2];
+		data[3] = m.data[3];
+	}
+
+	inline Vector3 Matrix::TransformVector(const Vector3& v) const
+	{
+		return TransformVector(v.x, v.y, v.z);
+	}
+
+	inline Vector3 Matrix::TransformVector(float x, float y, float z) const
+	{
+		const __m128 row{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(x), data[0].GetSSE()), _mm_mul_ps(_mm_set1_ps(y), data[1].GetSSE())), _mm_mul_ps(_mm_set1_ps(z), data[2].GetSSE())) };
+		return Vector4{ row }.GetXYZ();
+	}
+
+	inline Vector3 Matrix::TransformPoint(const Vector3& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z);
+	}
+
+	inline Vector3 Matrix::TransformPoint(float x, float y, float z) const
+	{
+		return TransformPoint(x, y, z, 1.f).GetXYZ();
+	}
+
+	inline Vector4 Matrix::TransformPoint(const Vector4& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z, p.w);
+	}
+
+	//w is not read, the point is taken to have a w of 1
+	inline Vector4 Matrix::TransformPoint(float x, float y, float z, float w) const
+	{
+		const __m128 row{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(x), data[0].GetSSE()), _mm_mul_ps(_mm_set1_ps(y), data[1].GetSSE())), _mm_mul_ps(_mm_set1_ps(z), data[2].GetSSE())) };
+		return Vector4{ _mm_add_ps(row, data[3].GetSSE()) };
+	}
+
+	inline void Matrix::TransformPoints(const Vector3* pPoints, Vector4* pTransformed, size_t count) const
+	{
+		const __m128 rows[4]{ data[0].GetSSE(), data[1].GetSSE(), data[2].GetSSE(), data[3].GetSSE() };
+
+		for (size_t idx{ 0 }; idx < count; ++idx)
+		{
+			const Vector3& point{ pPoints[idx] };
+			const __m128 row{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(point.x), rows[0]), _mm_mul_ps(_mm_set1_ps(point.y), rows[1])), _mm_mul_ps(_mm_set1_ps(point.z), rows[2])) };
+			_mm_store_ps(&pTransformed[idx].x, _mm_add_ps(row, rows[3]));
+		}
+	}
+
+	inline void Matrix::TransformPoints(const Vector4* pPoints, Vector4* pTransformed, size_t count) const
+	{
+		const __m128 rows[4]{ data[0].GetSSE(), data[1].GetSSE(), data[2].GetSSE(), data[3].GetSSE() };
+
+		for (size_t idx{ 0 }; idx < count; ++idx)
+		{
+			const __m128 point{ pPoints[idx].GetSSE() };
+			const __m128 x{ _mm_shuffle_ps(point, point, _MM_SHUFFLE(0, 0, 0, 0)) };
+			const __m128 y{ _mm_shuffle_ps(point, point, _MM_SHUFFLE(1, 1, 1, 1)) };
+			const __m128 z{ _mm_shuffle_ps(point, point, _MM_SHUFFLE(2, 2, 2, 2)) };
+			const __m128 row{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, rows[0]), _mm_mul_ps(y, rows[1])), _mm_mul_ps(z, rows[2])) };
+			_mm_store_ps(&pTransformed[idx].x, _mm_add_ps(row, rows[3]));
+		}
+	}
+
+	inline const Matrix& Matrix::Transpose()
+	{
+		__m128 rows[4]{ data[0].GetSSE(), data[1].GetSSE(), data[2].GetSSE(), data[3].GetSSE() };
+		_MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+
+		data[0] = Vector4{ rows[0] };
+		data[1] = Vector4{ rows[1] };
+		data[2] = Vector4{ rows[2] };
+		data[3] = Vector4{ rows[3] };
+
+		return *this;
+	}
+
+	inline const Matrix& Matrix::Inverse()
+	{
+		//Optimized Inverse as explained in FGED1 - used widely in other libraries too.
+		const Vector3& a = data[0];
+		const Vector3& b = data[1];
+		const Vector3& c = data[2];
+		const Vector3& d = data[3];
+
+		const float x = data[0][3];
+		const float y = data[1][3];
+		const float z = data[2][3];
+		const float w = data[3][3];
+
+		Vector3 s = Vector3::Cross(a, b);
+		Vector3 t = Vector3::Cross(c, d);
+		Vector3 u = a * y - b * x;
+		Vector3 v = c * w - d * z;
+
+		const float det = Vector3::Dot(s, v) + Vector3::Dot(t, u);
+		assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+		const float invDet = 1.f / det;
+
+		s *= invDet; t *= invDet; u *= invDet; v *= invDet;
+
+		const Vector3 r0 = Vector3::Cross(b, v) + t * y;
+		const Vector3 r1 = Vector3::Cross(v, a) - t * x;
+		const Vector3 r2 = Vector3::Cross(d, u) + s * w;
+		//Vector3 r3 = Vector3::Cross(u, c) - s * z;
+
+		data[0] = Vector4{ r0.x, r1.x, r2.x, 0.f };
+		data[1] = Vector4{ r0.y, r1.y, r2.y, 0.f };
+		data[2] = Vector4{ r0.z, r1.z, r2.z, 0.f };
+		data[3] = {-Vector3::Dot(b, t),Vector3::Dot(a, t),-Vector3::Dot(d, s),Vector3::Dot(c, s) };
+
+		return *this;
+	}
+
+	inline Matrix Matrix::Transpose(const Matrix& m)
+	{
+		Matrix out{ m };
+		out.Transpose();
+
+		return out;
+	}
+
+	inline Matrix Matrix::Inverse(const Matrix& m)
+	{
+		Matrix out{ m };
+		out.Inverse();
+
+		return out;
+	}
+
+	inline Matrix Matrix::CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up)
+	{
+		// Calculate the forward, right, and up vectors
+		const Vector3 rightVector{ Vector3::Cross(up.Normalized(), forward.Normalized()) };
+		const Vector3 upVector{ Vector3::Cross(forward.Normalized(), rightVector) };
+
+		//update matrix data
+		Matrix viewMatrix{
+			Vector4{rightVector, 0},
+			Vector4{upVector, 0},
+			Vector4{forward, 0},
+			Vector4{origin, 1}
+		};
+
+		return viewMatrix;
+	}
+
+	inline Matrix Matrix::CreatePerspectiveFovLH(float fov, float aspect, float zn, float zf)
+	{
+		const float A{ zf / (zf - zn) };
+		const float B{ -(zf * zn) / (zf - zn) };
+
+		return { Vector4{ 1.f / (aspect * fov), 0, 0, 0 },
+				 Vector4{ 0, 1.f / fov, 0, 0 },
+				 Vector4{ 0, 0, A, 1 },
+				 Vector4{ 0, 0, B, 0 } };
+	}
+
+	inline Vector3 Matrix::GetAxisX() const
+	{
+		return data[0];
+	}
+
+	inline Vector3 Matrix::GetAxisY() const
+	{
+		return data[1];
+	}
+
+	inline Vector3 Matrix::GetAxisZ() const
+	{
+		return data[2];
+	}
+
+	inline Vector3 Matrix::GetTranslation() const
+	{
+		return data[3];
+	}
+
+	inline Matrix Matrix::CreateTranslation(float x, float y, float z)
+	{
+		return CreateTranslation({ x, y, z });
+	}
+
+	inline Matrix Matrix::CreateTranslation(const Vector3& t)
+	{
+		return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
+	}
+
+	inline Matrix Matrix::CreateRotationX(float pitch)
+	{
+		return {
+			{1, 0, 0, 0},
+			{0, cos(pitch), -sin(pitch), 0},
+			{0, sin(pitch), cos(pitch), 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	inline Matrix Matrix::CreateRotationY(float yaw)
+	{
+		return {
+			{cos(yaw), 0, -sin(yaw), 0},
+			{0, 1, 0, 0},
+			{sin(yaw), 0, cos(yaw), 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	inline Matrix Matrix::CreateRotationZ(float roll)
+	{
+		return {
+			{cos(roll), sin(roll), 0, 0},
+			{-sin(roll), cos(roll), 0, 0},
+			{0, 0, 1, 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	inline Matrix Matrix::CreateRotation(float pitch, float yaw, float roll)
+	{
+		return CreateRotation({ pitch, yaw, roll });
+	}
+
+	inline Matrix Matrix::CreateRotation(const Vector3& r)
+	{
+		return CreateRotationX(r[0]) * CreateRotationY(r[1]) * CreateRotationZ(r[2]);
+	}
+
+	inline Matrix Matrix::CreateScale(float sx, float sy, float sz)
+	{
+		return { {sx, 0, 0}, {0, sy, 0}, {0, 0, sz}, Vector3::Zero };
+	}
+
+	inline Matrix Matrix::CreateScale(const Vector3& s)
+	{
+		return CreateScale(s[0], s[1], s[2]);
+	}
+
+#pragma region Operator Overloads
+	inline Vector4& Matrix::operator[](int index)
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	inline Vector4 Matrix::operator[](int index) const
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	//a row of the result is the rows of m weighted by the elements of our row, no transposed copy of m is needed.
+	//The products are summed in the same order as a dot product so the result does not change
+	inline Matrix Matrix::operator*(const Matrix& m) const
+	{
+		const __m128 rows[4]{ m.data[0].GetSSE(), m.data[1].GetSSE(), m.data[2].GetSSE(), m.data[3].GetSSE() };
+
+		Matrix result{};
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			const Vector4& row{ data[r] };
+			const __m128 sum{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(row.x), rows[0]), _mm_mul_ps(_mm_set1_ps(row.y), rows[1])), _mm_mul_ps(_mm_set1_ps(row.z), rows[2])) };
+			result.data[r] = Vector4{ _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row.w), rows[3])) };
+		}
+
+		return result;
+	}
+
+	inline const Matrix& Matrix::operator*=(const Matrix& m)
+	{
+		*this = *this * m;
+		return *this;
+	}
+
+	inline bool Matrix::operator==(const Matrix& m) const
+	{
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				if (data[r][c] != m[r][c])
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+#pragma endregion
+}
@@ -1,31 +1,66 @@
 #include "pch.h"
 #include "Mesh.h" 
+#include "AllocationTracker.h"
 #include <cassert>
 
 using namespace dae;
 
-Mesh::Mesh(ID3D11Device* pDevice, const std::vector<Vertex_PosCol>& vertexData, const std::vector<uint32_t> indexData, Effect* pEffect, bool isSoftware, Matrix worldMatrix) :
-	m_NumIndices{},
+Mesh::Mesh(ID3D11Device* pDevice, const std::vector<Vertex_PosCol>& vertexData, const std::vector<uint32_t>& indexData, Effect* pEffect, bool isSoftware, Residency residency, Matrix worldMatrix) :
+	m_NumVertices{ static_cast<uint32_t>(vertexData.size()) },
+	m_NumIndices{ static_cast<uint32_t>(indexData.size()) },
+	m_pVertexBuffer{},
 	m_pIndexBuffer{},
 	m_pInputLayout{},
 	m_WorldMatrix{ worldMatrix },
-	m_pEffect{ pEffect },
-	m_Vertices{ vertexData },
-	m_Indices{ indexData }
+	m_pEffect{ pEffect }
 {
+	const AllocationTracker::Scope allocationScope{ Subsystem::mesh };
+
 	m_pTechnique = m_pEffect->GetTechnique();
 
 	m_IsInSoftwareMode = isSoftware;
 
 	// Vertex / Input Layout and Buffer
-	VertexAndInputCreation(pDevice, vertexData, indexData);
+	if (residency != Residency::cpuOnly)
+	{
+		VertexAndInputCreation(pDevice, vertexData, indexData);
+	}
+
+	//the immutable buffers hold their own copy, a GPU only mesh keeps nothing on the CPU
+	if (residency != Residency::gpuOnly)
+	{
+		CreateVertexStreams(vertexData);
+		m_Indices = indexData;
+		AllocationTracker::CountCopy(m_Indices.size() * sizeof(uint32_t));
+	}
 }
 
 Mesh::~Mesh()
 {
-	m_pVertexBuffer->Release();
-	m_pIndexBuffer->Release();
-	m_pInputLayout->Release();
+	if (m_pVertexBuffer != nullptr)
+	{
+		m_pVertexBuffer->Release();
+	}
+
+	if (m_pIndexBuffer != nullptr)
+	{
+		m_pIndexBuffer->Release();
+	}
+
+	if (m_pInputLayout != nullptr)
+	{
+		m_pInputLayout->Release();
+	}
+
+	if (m_pNormalRotationView != nullptr)
+	{
+		m_pNormalRotationView->Release();
+	}
+
+	if (m_pNormalRotationBuffer != nullptr)
+	{
+		m_pNormalRotationBuffer->Release();
+	}
 
 	// Double deletion, effect and technique does not get handeled in Mesh & gets deleted in Effect class.
 	// Effect object is now owned by mesh, simply utilised. Technique is derrived from Effect.
@@ -40,6 +75,13 @@ Mesh::~Mesh()
 
 void Mesh::Render(ID3D11DeviceContext* pDeviceContext, Matrix worldViewProjectionMatrix)
 {
+	const AllocationTracker::Scope allocationScope{ Subsystem::mesh };
+
+	if (m_pVertexBuffer == nullptr)
+	{
+		return;
+	}
+
 	//1. Set Primitive Topology
 	pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
@@ -98,12 +140,60 @@ bool dae::Mesh::GetIsInSoftwareMode() const
 	return m_IsInSoftwareMode;
 }
 
-std::vector<Vertex_PosCol> Mesh::GetMeshVertices() const
+void Mesh::CreateNormalRotationBuffer(ID3D11Device* pDevice, const std::vector<Matrix>& normalRotations)
+{
+	const AllocationTracker::Scope allocationScope{ Subsystem::mesh };
+
+	//the fourth row of a rotation is never used, the shader reads three rows per primitive
+	std::vector<Vector4> rows{};
+	rows.reserve(normalRotations.size() * 3);
+	for (const Matrix& rotation : normalRotations)
+	{
+		rows.push_back(rotation[0]);
+		rows.push_back(rotation[1]);
+		rows.push_back(rotation[2]);
+	}
+
+	D3D11_BUFFER_DESC bd = {};
+	bd.Usage = D3D11_USAGE_IMMUTABLE;
+	bd.ByteWidth = sizeof(Vector4) * static_cast<uint32_t>(rows.size());
+	bd.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	bd.CPUAccessFlags = 0;
+	bd.MiscFlags = 0;
+
+	D3D11_SUBRESOURCE_DATA initData = {};
+	initData.pSysMem = rows.data();
+
+	HRESULT result = pDevice->CreateBuffer(&bd, &initData, &m_pNormalRotationBuffer);
+	if (FAILED(result))
+	{
+		return;
+	}
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	srvDesc.Buffer.FirstElement = 0;
+	srvDesc.Buffer.NumElements = static_cast<uint32_t>(rows.size());
+
+	result = pDevice->CreateShaderResourceView(m_pNormalRotationBuffer, &srvDesc, &m_pNormalRotationView);
+	if (FAILED(result))
+	{
+		return;
+	}
+}
+
+ID3D11ShaderResourceView* Mesh::GetNormalRotationView() const
 {
-	return m_Vertices;
+	return m_pNormalRotationView;
 }
 
-std::vector<uint32_t> Mesh::GetMeshIndices() const
+const VertexStreams& Mesh::GetVertexStreams() const
+{
+	return m_VertexStreams;
+}
+
+std::span<const uint32_t> Mesh::GetMeshIndices() const
 {
 	return m_Indices;
 }
@@ -113,11 +203,74 @@ PrimitiveTopology Mesh::GetPrimitiveTopology() const
 	return m_PrimitiveTopology;
 }
 
-std::vector<Vertex_Out>& Mesh::GetMeshVerticesOut()
+std::span<const Matrix> Mesh::GetNormalRotations() const
+{
+	return m_NormalRotations;
+}
+
+void Mesh::SetNormalRotations(std::vector<Matrix>&& normalRotations)
+{
+	assert(normalRotations.size() * 3 == m_NumIndices);
+
+	m_NormalRotations = std::move(normalRotations);
+}
+
+std::span<const Vertex_Out> Mesh::GetMeshVerticesOut() const
 {
 	return m_VerticesOut;
 }
 
+std::span<const Matrix> Mesh::GetNormalMatricesOut() const
+{
+	return m_NormalMatricesOut;
+}
+
+void Mesh::SetMeshVerticesOut(std::span<const Vertex_Out> verticesOut)
+{
+	m_VerticesOut = verticesOut;
+}
+
+void Mesh::SetNormalMatricesOut(std::span<const Matrix> normalMatricesOut)
+{
+	m_NormalMatricesOut = normalMatricesOut;
+}
+
+void Mesh::SetCpuData(std::vector<Vertex_PosCol>&& vertices, std::vector<uint32_t>&& indices)
+{
+	const AllocationTracker::Scope allocationScope{ Subsystem::mesh };
+
+	assert(m_pVertexBuffer == nullptr || (vertices.size() == m_NumVertices && indices.size() == m_NumIndices));
+
+	CreateVertexStreams(vertices);
+	m_Indices = std::move(indices);
+}
+
+Residency Mesh::GetResidency() const
+{
+	if (m_pVertexBuffer == nullptr)
+	{
+		return Residency::cpuOnly;
+	}
+
+	return m_VertexStreams.amountOfVertices == 0 ? Residency::gpuOnly : Residency::both;
+}
+
+size_t Mesh::GetCpuBytes() const
+{
+	//every stream holds as many floats as the first one
+	const size_t amountOfStreams{ std::size(m_VertexStreams.position) + std::size(m_VertexStreams.normal) + std::size(m_VertexStreams.uv) + std::size(m_VertexStreams.color) };
+	const size_t streamBytes{ m_VertexStreams.position[0].capacity() * sizeof(float) * amountOfStreams };
+
+	//the transformed vertices and normal matrices are counted with the renderer's frame arena
+	return streamBytes + (m_Indices.capacity() * sizeof(uint32_t)) + (m_NormalRotations.capacity() * sizeof(Matrix));
+}
+
+size_t Mesh::GetGpuBytes() const
+{
+	const size_t normalRotationBytes{ m_pNormalRotationBuffer != nullptr ? size_t(m_NumIndices) * sizeof(Vector4) : 0 };
+	return m_pVertexBuffer != nullptr ? (size_t(m_NumVertices) * sizeof(Vertex_PosCol)) + (size_t(m_NumIndices) * sizeof(uint32_t)) + normalRotationBytes : 0;
+}
+
 void Mesh::ToggleSamplerState()
 {
 	m_pEffect->ToggleSamplerState();
@@ -140,7 +293,7 @@ void Mesh::RotateMesh(float rotation)
 	m_WorldMatrix = m_ScaleMatrix * m_RotationMatrix * m_TranslationMatrix; 
 }
 
-void Mesh::VertexAndInputCreation(ID3D11Device* pDevice, const std::vector<Vertex_PosCol>& vertexData, const std::vector<uint32_t> indexData)
+void Mesh::VertexAndInputCreation(ID3D11Device* pDevice, const std::vector<Vertex_PosCol>& vertexData, const std::vector<uint32_t>& indexData)
 {
 	//Create Vertex Layout
 	static constexpr uint32_t numElements{ 4 };
@@ -219,3 +372,42 @@ void Mesh::VertexAndInputCreation(ID3D11Device* pDevice, const std::vector<Verte
 		return;
 	}
 }
+
+void Mesh::CreateVertexStreams(const std::vector<Vertex_PosCol>& vertexData)
+{
+	m_VertexStreams.amountOfVertices = vertexData.size();
+
+	const size_t paddedSize{ ((vertexData.size() + VertexStreams::m_Lanes - 1) / VertexStreams::m_Lanes) * VertexStreams::m_Lanes };
+
+	for (std::vector<float>* pStreams : { m_VertexStreams.position, m_VertexStreams.normal, m_VertexStreams.color })
+	{
+		for (int component{ 0 }; component < 3; ++component)
+		{
+			pStreams[component].resize(paddedSize);
+		}
+	}
+
+	m_VertexStreams.uv[0].resize(paddedSize);
+	m_VertexStreams.uv[1].resize(paddedSize);
+
+	for (size_t idx{ 0 }; idx < paddedSize; ++idx)
+	{
+		const Vertex_PosCol& vertex{ vertexData[std::min(idx, vertexData.size() - 1)] };
+
+		m_VertexStreams.position[0][idx] = vertex.position.x;
+		m_VertexStreams.position[1][idx] = vertex.position.y;
+		m_VertexStreams.position[2][idx] = vertex.position.z;
+		m_VertexStreams.normal[0][idx] = vertex.normal.x;
+		m_VertexStreams.normal[1][idx] = vertex.normal.y;
+		m_VertexStreams.normal[2][idx] = vertex.normal.z;
+		m_VertexStreams.uv[0][idx] = vertex.uv.x;
+		m_VertexStreams.uv[1][idx] = vertex.uv.y;
+		m_VertexStreams.color[0][idx] = vertex.color.r;
+		m_VertexStreams.color[1][idx] = vertex.color.g;
+		m_VertexStreams.color[2][idx] = vertex.color.b;
+	}
+
+	//counted as one copy, the vertices are only split up per component
+	const size_t amountOfStreams{ std::size(m_VertexStreams.position) + std::size(m_VertexStreams.normal) + std::size(m_VertexStreams.uv) + std::size(m_VertexStreams.color) };
+	AllocationTracker::CountCopy(paddedSize * amountOfStreams * sizeof(float));
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "EffectVehicle.h"
+#include "Residency.h"
 
 namespace dae
 {
@@ -13,13 +14,25 @@ namespace dae
 		ColorRGB color{};
 	};
 
+	// The software copy of the vertices, one array per component so the transform loads a component of 8 or 16 vertices at once.
+	// Every array is padded to a multiple of m_Lanes, the width of the widest kernel, with copies of the last vertex so a chunk never needs a scalar tail
+	struct VertexStreams
+	{
+		static constexpr size_t m_Lanes{ 16 };
+
+		size_t amountOfVertices{};
+		std::vector<float> position[3]{};
+		std::vector<float> normal[3]{};
+		std::vector<float> uv[2]{};
+		std::vector<float> color[3]{};
+	};
+
 	struct Vertex_Out
 	{
 		Vector4 position{};
 		ColorRGB color{};
 		Vector2 uv{};
 		Vector3 normal{};
-		Vector3 tangent{};
 		Vector3 viewDirection{};
 	};
 
@@ -33,7 +46,7 @@ namespace dae
 	{
 	public:
 		// CONSTRUCTOR AND DESTRUCTOR
-		Mesh(ID3D11Device* pDevice, const std::vector<Vertex_PosCol>& vertexData, const std::vector<uint32_t> indexData, Effect* pEffect, bool isSoftware,
+		Mesh(ID3D11Device* pDevice, const std::vector<Vertex_PosCol>& vertexData, const std::vector<uint32_t>& indexData, Effect* pEffect, bool isSoftware, Residency residency,
 			 Matrix worldMatrix = Matrix{ Vector4{1, 0, 0, 0}, Vector4{0, 1, 0, 0}, Vector4{0, 0, 1, 0}, Vector4{0, 0, 0, 1} });
 		~Mesh();
 
@@ -56,11 +69,30 @@ namespace dae
 		Effect* GetEffect() const;
 		bool GetIsInSoftwareMode() const;
 
+		//one rotation per triangle as three float4 rows, for meshes whose normal map is baked to object space
+		void CreateNormalRotationBuffer(ID3D11Device* pDevice, const std::vector<Matrix>& normalRotations);
+		ID3D11ShaderResourceView* GetNormalRotationView() const;
+
+		// SHARED MEMBER FUNCTIONS
+		Residency GetResidency() const;
+		size_t GetCpuBytes() const;
+		size_t GetGpuBytes() const;
+
 		// SOFTWARE MEMBER FUNCTIONS
-		std::vector<Vertex_PosCol> GetMeshVertices() const;
-		std::vector<uint32_t> GetMeshIndices() const; 
+		const VertexStreams& GetVertexStreams() const;
+		std::span<const uint32_t> GetMeshIndices() const; 
 		PrimitiveTopology GetPrimitiveTopology() const;
-		std::vector<Vertex_Out>& GetMeshVerticesOut(); 
+		std::span<const Matrix> GetNormalRotations() const;
+		void SetNormalRotations(std::vector<Matrix>&& normalRotations);
+
+		//the transformed data lives in the renderer's frame arena, only valid until the arena is reset
+		std::span<const Vertex_Out> GetMeshVerticesOut() const; 
+		std::span<const Matrix> GetNormalMatricesOut() const;
+		void SetMeshVerticesOut(std::span<const Vertex_Out> verticesOut);
+		void SetNormalMatricesOut(std::span<const Matrix> normalMatricesOut);
+
+		//the CPU copy has to match what was uploaded, so it comes from the same source asset
+		void SetCpuData(std::vector<Vertex_PosCol>&& vertices, std::vector<uint32_t>&& indices);
 
 	private:
 		// HARDWARE MEMBER VARIABLES
@@ -69,7 +101,10 @@ namespace dae
 		ID3D11InputLayout* m_pInputLayout;
 		ID3D11Buffer* m_pVertexBuffer;
 		ID3D11Buffer* m_pIndexBuffer;
+		ID3D11Buffer* m_pNormalRotationBuffer{ nullptr };
+		ID3D11ShaderResourceView* m_pNormalRotationView{ nullptr };
 
+		uint32_t m_NumVertices;
 		uint32_t m_NumIndices;
 		Matrix m_WorldMatrix;
 		Matrix m_WorldViewProjectionMatrix;
@@ -78,15 +113,20 @@ namespace dae
 		Matrix m_ScaleMatrix;
 
 		// SOFTWARE MEMBER VARIABLES
-		std::vector<Vertex_PosCol> m_Vertices{};
+		//only filled while the mesh is CPU resident
+		VertexStreams m_VertexStreams{};
 		std::vector<uint32_t> m_Indices{};
 		PrimitiveTopology m_PrimitiveTopology{ PrimitiveTopology::TriangleList }; 
-		std::vector<Vertex_Out> m_VerticesOut{};
+		std::span<const Vertex_Out> m_VerticesOut{};
+		//per triangle, empty for meshes without a baked normal map
+		std::vector<Matrix> m_NormalRotations{};
+		std::span<const Matrix> m_NormalMatricesOut{};
 
 		bool m_IsInSoftwareMode{ true }; 
 
 		// MEMBER FUNCTION
-		void VertexAndInputCreation(ID3D11Device* pDevice, const std::vector<Vertex_PosCol>& vertexData, const std::vector<uint32_t> indexData);
+		void VertexAndInputCreation(ID3D11Device* pDevice, const std::vector<Vertex_PosCol>& vertexData, const std::vector<uint32_t>& indexData);
+		void CreateVertexStreams(const std::vector<Vertex_PosCol>& vertexData);
 	};
 }
 
@@ -0,0 +1,49 @@
+#include "pch.h"
+#include "MipChain.h"
+
+using namespace dae;
+
+MipChain::MipChain(int width, int height)
+{
+	//halve both sides until the last level is a single texel, like a full D3D11 mip chain
+	while (true)
+	{
+		MipLevel mip{};
+		mip.width = width;
+		mip.height = height;
+		mip.tilesPerRow = (width + m_TexelTileSize - 1) / m_TexelTileSize;
+		mip.firstTexelIdx = m_AmountOfTexels;
+
+		const int amountOfTileRows{ (height + m_TexelTileSize - 1) / m_TexelTileSize };
+		m_AmountOfTexels += mip.tilesPerRow * amountOfTileRows * m_TexelTileSize * m_TexelTileSize;
+		m_Levels.push_back(mip);
+
+		if (width == 1 && height == 1)
+		{
+			break;
+		}
+
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+	}
+}
+
+int MipChain::GetAmountOfLevels() const
+{
+	return static_cast<int>(m_Levels.size());
+}
+
+int MipChain::GetAmountOfTexels() const
+{
+	return m_AmountOfTexels;
+}
+
+int MipChain::GetAmountOfBlocks() const
+{
+	return m_AmountOfTexels / BlockCompression::m_TexelsPerBlock;
+}
+
+const MipChain::MipLevel& MipChain::GetLevel(int level) const
+{
+	return m_Levels[level];
+}
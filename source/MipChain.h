@@ -0,0 +1,207 @@
+#pragma once
+#include "BlockCompression.h"
+
+namespace dae
+{
+	// Software counterpart of a D3D11 sampler state: point or linear filtering, anisotropic when maxAnisotropy > 1
+	struct SamplerDesc
+	{
+		bool isLinear{ false };
+		int maxAnisotropy{ 1 };
+	};
+
+	// Layout of a software texture's mip chain, every level stored block by block and the levels one after the other,
+	// plus the filtering shared by every texel format that is stored this way
+	class MipChain final
+	{
+	public:
+		// CONSTANTS
+		//a tile is one 4x4 compressed block, so a level is laid out exactly like its D3D subresource
+		static constexpr int m_TexelTileSize{ BlockCompression::m_BlockSize };
+
+		//same limit as the anisotropic hardware sampler state
+		static constexpr int m_MaxAnisotropy{ 16 };
+
+		// STRUCTS
+		struct MipLevel
+		{
+			int width{};
+			int height{};
+			int tilesPerRow{};
+			int firstTexelIdx{};
+		};
+
+		// CONSTRUCTOR
+		MipChain() = default;
+		MipChain(int width, int height);
+
+		// MEMBER FUNCTIONS
+		int GetAmountOfLevels() const;
+		int GetAmountOfTexels() const;
+		int GetAmountOfBlocks() const;
+		const MipLevel& GetLevel(int level) const;
+
+		int GetBlockIndex(int x, int y, int level) const
+		{
+			//the blocks of all levels before this one, then the block inside the level
+			const MipLevel& mip{ m_Levels[level] };
+			return (mip.firstTexelIdx / BlockCompression::m_TexelsPerBlock) + (x / m_TexelTileSize) + ((y / m_TexelTileSize) * mip.tilesPerRow);
+		}
+
+		static int GetTexelInBlockIndex(int x, int y)
+		{
+			return (x % m_TexelTileSize) + ((y % m_TexelTileSize) * m_TexelTileSize);
+		}
+
+		// Filters texels of Channels bytes each, picking the level(s) from the screen space uv derivatives.
+		// fetchBlock(blockIdx) returns the 16 decoded texels of a block. Every channel of the result stays in [0, 255]
+		template<int Channels, typename BlockFetch>
+		void Sample(const BlockFetch& fetchBlock, const SamplerDesc& sampler, const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, float (&result)[Channels]) const;
+
+	private:
+		// MEMBER VARIABLES
+		std::vector<MipLevel> m_Levels{};
+		int m_AmountOfTexels{};
+
+		// MEMBER FUNCTIONS
+		template<int Channels>
+		static void AccumulateTexel(const uint8_t* pBlock, int x, int y, float weight, float (&result)[Channels]);
+
+		template<int Channels, typename BlockFetch>
+		void AccumulateBilinear(const BlockFetch& fetchBlock, float u, float v, int level, float weight, float (&result)[Channels]) const;
+
+		static int WrapCoordinate(int coordinate, int size)
+		{
+			//coordinates come from a uv wrapped to [0, 1], so they are at most one texel outside the level
+			if (coordinate < 0)
+			{
+				return coordinate + size;
+			}
+
+			return coordinate >= size ? coordinate - size : coordinate;
+		}
+	};
+
+	template<int Channels, typename BlockFetch>
+	void MipChain::Sample(const BlockFetch& fetchBlock, const SamplerDesc& sampler, const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, float (&result)[Channels]) const
+	{
+		std::fill_n(result, Channels, 0.f);
+
+		//footprint of the pixel in texels of the most detailed level, squared so the isotropic case needs no square root,
+		//a helper pixel behind the camera has no footprint
+		const float width{ static_cast<float>(m_Levels[0].width) };
+		const float height{ static_cast<float>(m_Levels[0].height) };
+		float squaredLengthX{ Square(uvDdx.x * width) + Square(uvDdx.y * height) };
+		float squaredLengthY{ Square(uvDdy.x * width) + Square(uvDdy.y * height) };
+		if (!std::isfinite(squaredLengthX + squaredLengthY))
+		{
+			squaredLengthX = 0.f;
+			squaredLengthY = 0.f;
+		}
+
+		float squaredFootprint{ std::max(squaredLengthX, squaredLengthY) };
+		int amountOfProbes{ 1 };
+		float probeStepU{};
+		float probeStepV{};
+
+		//anisotropic filtering probes along the major axis and picks the level from what is left of the footprint per probe
+		if (sampler.isLinear && sampler.maxAnisotropy > 1 && squaredFootprint > 0.f)
+		{
+			const float majorLength{ sqrtf(squaredFootprint) };
+			const float minorLength{ std::max(sqrtf(std::min(squaredLengthX, squaredLengthY)), majorLength / sampler.maxAnisotropy) };
+			amountOfProbes = std::min(static_cast<int>(std::ceil(majorLength / minorLength)), sampler.maxAnisotropy);
+
+			const Vector2& majorAxis{ squaredLengthX >= squaredLengthY ? uvDdx : uvDdy };
+			probeStepU = majorAxis.x / amountOfProbes;
+			probeStepV = majorAxis.y / amountOfProbes;
+			squaredFootprint /= static_cast<float>(amountOfProbes * amountOfProbes);
+		}
+
+		//magnification and a footprint of nothing both use the most detailed level
+		const int lastLevel{ static_cast<int>(m_Levels.size()) - 1 };
+
+		if (!sampler.isLinear)
+		{
+			//nearest level, nearest texel: round(log2(footprint)) is floor(log2(2 * squaredFootprint) / 2), straight from the exponent bits
+			const int roundedLog2{ static_cast<int>(std::bit_cast<uint32_t>(squaredFootprint * 2.f) >> 23) - 127 };
+			const int level{ std::clamp(roundedLog2 >> 1, 0, lastLevel) };
+			const MipLevel& mip{ m_Levels[level] };
+			const int x{ WrapCoordinate(static_cast<int>((uv.x - std::floor(uv.x)) * mip.width), mip.width) };
+			const int y{ WrapCoordinate(static_cast<int>((uv.y - std::floor(uv.y)) * mip.height), mip.height) };
+
+			AccumulateTexel(fetchBlock(GetBlockIndex(x, y, level)), x, y, 1.f, result);
+			return;
+		}
+
+		float lod{ 0.5f * FastLog2(squaredFootprint) };
+		lod = lod > 0.f ? std::min(lod, static_cast<float>(lastLevel)) : 0.f;
+
+		//trilinear between the two nearest levels, once per probe
+		const int lowerLevel{ static_cast<int>(lod) };
+		const int upperLevel{ std::min(lowerLevel + 1, lastLevel) };
+		const float upperWeight{ lod - lowerLevel };
+		const float probeWeight{ 1.f / amountOfProbes };
+
+		for (int probeIdx{ 0 }; probeIdx < amountOfProbes; ++probeIdx)
+		{
+			//probes are spread evenly over the major axis, centred on the pixel
+			const float probeOffset{ probeIdx + 0.5f - (amountOfProbes * 0.5f) };
+			const float probeU{ uv.x + (probeStepU * probeOffset) };
+			const float probeV{ uv.y + (probeStepV * probeOffset) };
+
+			AccumulateBilinear(fetchBlock, probeU, probeV, lowerLevel, probeWeight * (1.f - upperWeight), result);
+			if (upperWeight > 0.f)
+			{
+				AccumulateBilinear(fetchBlock, probeU, probeV, upperLevel, probeWeight * upperWeight, result);
+			}
+		}
+	}
+
+	template<int Channels>
+	void MipChain::AccumulateTexel(const uint8_t* pBlock, int x, int y, float weight, float (&result)[Channels])
+	{
+		const uint8_t* pTexel{ pBlock + (GetTexelInBlockIndex(x, y) * Channels) };
+
+		for (int channelIdx{ 0 }; channelIdx < Channels; ++channelIdx)
+		{
+			result[channelIdx] += pTexel[channelIdx] * weight;
+		}
+	}
+
+	template<int Channels, typename BlockFetch>
+	void MipChain::AccumulateBilinear(const BlockFetch& fetchBlock, float u, float v, int level, float weight, float (&result)[Channels]) const
+	{
+		//texel centres sit on half coordinates, the sampler state wraps
+		const MipLevel& mip{ m_Levels[level] };
+		const float x{ ((u - std::floor(u)) * mip.width) - 0.5f };
+		const float y{ ((v - std::floor(v)) * mip.height) - 0.5f };
+		const float floorX{ std::floor(x) };
+		const float floorY{ std::floor(y) };
+		const float fractionX{ x - floorX };
+		const float fractionY{ y - floorY };
+
+		const int x0{ WrapCoordinate(static_cast<int>(floorX), mip.width) };
+		const int y0{ WrapCoordinate(static_cast<int>(floorY), mip.height) };
+		const int x1{ WrapCoordinate(static_cast<int>(floorX) + 1, mip.width) };
+		const int y1{ WrapCoordinate(static_cast<int>(floorY) + 1, mip.height) };
+
+		const int blockIdx00{ GetBlockIndex(x0, y0, level) };
+		const int blockIdx10{ GetBlockIndex(x1, y0, level) };
+		const int blockIdx01{ GetBlockIndex(x0, y1, level) };
+		const int blockIdx11{ GetBlockIndex(x1, y1, level) };
+
+		//the blocks of a footprint can share an entry of the block cache, so a block is read before the next one is fetched
+		//and only kept for the next texel when that texel is in the same block. Most footprints lie inside one block
+		const uint8_t* pBlock{ fetchBlock(blockIdx00) };
+		AccumulateTexel(pBlock, x0, y0, weight * (1.f - fractionX) * (1.f - fractionY), result);
+
+		pBlock = blockIdx10 == blockIdx00 ? pBlock : fetchBlock(blockIdx10);
+		AccumulateTexel(pBlock, x1, y0, weight * fractionX * (1.f - fractionY), result);
+
+		pBlock = blockIdx01 == blockIdx10 ? pBlock : fetchBlock(blockIdx01);
+		AccumulateTexel(pBlock, x0, y1, weight * (1.f - fractionX) * fractionY, result);
+
+		pBlock = blockIdx11 == blockIdx01 ? pBlock : fetchBlock(blockIdx11);
+		AccumulateTexel(pBlock, x1, y1, weight * fractionX * fractionY, result);
+	}
+}
@@ -0,0 +1,311 @@
+#include "pch.h"
+#include "NormalMapBaker.h"
+#include "Mesh.h"
+#include "AllocationTracker.h"
+#include <array>
+#include <execution>
+#include <numeric>
+
+using namespace dae;
+
+//rows tangent, binormal and normal of the vertex frames averaged over a triangle, identity if they do not span a frame
+static Matrix GetFaceFrame(const std::vector<Vertex_PosCol>& vertices, const std::vector<uint32_t>& indices, size_t triangleIdx)
+{
+	const Vertex_PosCol& vertex0{ vertices[indices[triangleIdx * 3]] };
+	const Vertex_PosCol& vertex1{ vertices[indices[(triangleIdx * 3) + 1]] };
+	const Vertex_PosCol& vertex2{ vertices[indices[(triangleIdx * 3) + 2]] };
+
+	const Vector3 normal{ vertex0.normal + vertex1.normal + vertex2.normal };
+	const Vector3 tangent{ vertex0.tangent + vertex1.tangent + vertex2.tangent };
+	if (normal.SqrMagnitude() == 0.f || Vector3::Cross(normal, tangent).SqrMagnitude() == 0.f)
+	{
+		return Matrix{};
+	}
+
+	//the binormal is the cross product without a handedness sign, like the shaders built it
+	const Vector3 frameNormal{ normal.Normalized() };
+	const Vector3 frameTangent{ Vector3::Reject(tangent, frameNormal).Normalized() };
+	return Matrix{ frameTangent, Vector3::Cross(frameNormal, frameTangent), frameNormal, Vector3::Zero };
+}
+
+std::vector<Matrix> NormalMapBaker::ComputeNormalRotations(const std::vector<Vertex_PosCol>& vertices, const std::vector<uint32_t>& indices, int width, int height)
+{
+	const size_t numTriangles{ indices.size() / 3 };
+	const std::vector<UVTriangle> triangles{ SetupUVTriangles(vertices, indices, width, height) };
+	const std::vector<int> owners{ FindTexelOwners(vertices, indices, triangles, width, height) };
+
+	//a triangle follows the owner of most of its texels, triangles covering no texel centre follow the texel their uv centre is in
+	std::vector<int> triangleOwners(numTriangles, -1);
+	std::vector<std::pair<int, int>> votes{};
+
+	for (const UVTriangle& triangle : triangles)
+	{
+		votes.clear();
+		ForEachCoveredTexel(triangle, triangle.minY, triangle.maxY, width, [&](int x, int y, const float (&)[3])
+			{
+				const int owner{ owners[size_t(x) + (size_t(y) * width)] };
+				auto it{ std::find_if(votes.begin(), votes.end(), [owner](const std::pair<int, int>& vote) { return vote.first == owner; }) };
+				if (it == votes.end())
+				{
+					votes.push_back({ owner, 1 });
+				}
+				else
+				{
+					++it->second;
+				}
+			});
+
+		if (!votes.empty())
+		{
+			triangleOwners[triangle.triangleIdx] = std::max_element(votes.begin(), votes.end(), [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) { return lhs.second < rhs.second; })->first;
+		}
+	}
+
+	std::vector<Matrix> rotations(numTriangles);
+	for (size_t triangleIdx{ 0 }; triangleIdx < numTriangles; ++triangleIdx)
+	{
+		int owner{ triangleOwners[triangleIdx] };
+		if (owner < 0)
+		{
+			Vector2 centre{};
+			for (int vertexIdx{ 0 }; vertexIdx < 3; ++vertexIdx)
+			{
+				centre += vertices[indices[(triangleIdx * 3) + vertexIdx]].uv / 3.f;
+			}
+
+			const int x{ std::clamp(static_cast<int>(centre.x * width), 0, width - 1) };
+			const int y{ std::clamp(static_cast<int>(centre.y * height), 0, height - 1) };
+			owner = owners[size_t(x) + (size_t(y) * width)];
+		}
+
+		if (owner >= 0 && size_t(owner) != triangleIdx)
+		{
+			rotations[triangleIdx] = Matrix::Transpose(GetFaceFrame(vertices, indices, owner)) * GetFaceFrame(vertices, indices, triangleIdx);
+		}
+	}
+
+	return rotations;
+}
+
+void NormalMapBaker::BakeObjectSpaceNormals(const std::vector<Vertex_PosCol>& vertices, const std::vector<uint32_t>& indices, const std::vector<Matrix>& rotations, std::vector<uint32_t>& texels, int width, int height)
+{
+	const std::vector<UVTriangle> triangles{ SetupUVTriangles(vertices, indices, width, height) };
+	const std::vector<int> owners{ FindTexelOwners(vertices, indices, triangles, width, height) };
+
+	std::vector<Vector3> normals(size_t(width) * height);
+	std::vector<uint8_t> isCovered(size_t(width) * height);
+
+	ForEachBand(height, [&](int bandMinY, int bandMaxY)
+		{
+			for (const UVTriangle& triangle : triangles)
+			{
+				//the owner's normal goes back through its rotation, into the frame every triangle sharing the texel rotates from
+				const Matrix inverseRotation{ Matrix::Transpose(rotations[triangle.triangleIdx]) };
+				const Vertex_PosCol* pVertices[3]{};
+				for (int vertexIdx{ 0 }; vertexIdx < 3; ++vertexIdx)
+				{
+					pVertices[vertexIdx] = &vertices[indices[(size_t(triangle.triangleIdx) * 3) + vertexIdx]];
+				}
+
+				ForEachCoveredTexel(triangle, std::max(triangle.minY, bandMinY), std::min(triangle.maxY, bandMaxY), width, [&](int x, int y, const float (&weights)[3])
+					{
+						const size_t texelIdx{ size_t(x) + (size_t(y) * width) };
+						if (owners[texelIdx] != static_cast<int>(triangle.triangleIdx))
+						{
+							return;
+						}
+
+						//the same tangent frame the shaders built per pixel
+						const Vector3 normal{ ((pVertices[0]->normal * weights[0]) + (pVertices[1]->normal * weights[1]) + (pVertices[2]->normal * weights[2])).Normalized() };
+						const Vector3 tangent{ ((pVertices[0]->tangent * weights[0]) + (pVertices[1]->tangent * weights[1]) + (pVertices[2]->tangent * weights[2])).Normalized() };
+						const Vector3 binormal{ Vector3::Cross(normal, tangent) };
+
+						const uint32_t texel{ texels[texelIdx] };
+						const Vector3 tangentSpaceNormal{ ((texel & 0xFF) / 255.f * 2.f) - 1.f, (((texel >> 8) & 0xFF) / 255.f * 2.f) - 1.f, (((texel >> 16) & 0xFF) / 255.f * 2.f) - 1.f };
+						const Vector3 objectSpaceNormal{ (tangent * tangentSpaceNormal.x) + (binormal * tangentSpaceNormal.y) + (normal * tangentSpaceNormal.z) };
+
+						normals[texelIdx] = inverseRotation.TransformVector(objectSpaceNormal).Normalized();
+						isCovered[texelIdx] = 1;
+					});
+			}
+		});
+
+	//grow the islands one texel per pass, so filtering at their edges never pulls in texels no triangle covers
+	std::vector<uint8_t> wasCovered{};
+	for (int pass{ 0 }; pass < m_DilationTexels; ++pass)
+	{
+		wasCovered = isCovered;
+
+		for (int y{ 0 }; y < height; ++y)
+		{
+			for (int x{ 0 }; x < width; ++x)
+			{
+				const size_t texelIdx{ size_t(x) + (size_t(y) * width) };
+				if (wasCovered[texelIdx])
+				{
+					continue;
+				}
+
+				Vector3 sum{};
+				for (int neighbourY{ std::max(y - 1, 0) }; neighbourY <= std::min(y + 1, height - 1); ++neighbourY)
+				{
+					for (int neighbourX{ std::max(x - 1, 0) }; neighbourX <= std::min(x + 1, width - 1); ++neighbourX)
+					{
+						const size_t neighbourIdx{ size_t(neighbourX) + (size_t(neighbourY) * width) };
+						if (wasCovered[neighbourIdx])
+						{
+							sum += normals[neighbourIdx];
+						}
+					}
+				}
+
+				if (sum.SqrMagnitude() > 0.f)
+				{
+					normals[texelIdx] = sum.Normalized();
+					isCovered[texelIdx] = 1;
+				}
+			}
+		}
+	}
+
+	for (size_t texelIdx{ 0 }; texelIdx < texels.size(); ++texelIdx)
+	{
+		texels[texelIdx] = EncodeOctahedral(isCovered[texelIdx] ? normals[texelIdx] : Vector3::UnitZ);
+	}
+}
+
+uint32_t NormalMapBaker::EncodeOctahedral(const Vector3& normal)
+{
+	//project on the octahedron |x| + |y| + |z| = 1 and unfold its lower half over the diagonals
+	const float invLength{ 1.f / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z)) };
+	float x{ normal.x * invLength };
+	float y{ normal.y * invLength };
+
+	if (normal.z < 0.f)
+	{
+		const float foldedX{ (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f) };
+		const float foldedY{ (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f) };
+		x = foldedX;
+		y = foldedY;
+	}
+
+	const uint32_t encodedX{ static_cast<uint32_t>((std::clamp((x * 0.5f) + 0.5f, 0.f, 1.f) * 65535.f) + 0.5f) };
+	const uint32_t encodedY{ static_cast<uint32_t>((std::clamp((y * 0.5f) + 0.5f, 0.f, 1.f) * 65535.f) + 0.5f) };
+
+	return encodedX | (encodedY << 16);
+}
+
+std::vector<NormalMapBaker::UVTriangle> NormalMapBaker::SetupUVTriangles(const std::vector<Vertex_PosCol>& vertices, const std::vector<uint32_t>& indices, int width, int height)
+{
+	std::vector<UVTriangle> triangles{};
+	triangles.reserve(indices.size() / 3);
+
+	for (size_t idx{ 0 }; idx + 2 < indices.size(); idx += 3)
+	{
+		UVTriangle triangle{};
+		triangle.triangleIdx = static_cast<uint32_t>(idx / 3);
+		for (int vertexIdx{ 0 }; vertexIdx < 3; ++vertexIdx)
+		{
+			const Vector2& uv{ vertices[indices[idx + vertexIdx]].uv };
+			triangle.uv[vertexIdx] = Vector2{ uv.x * width, uv.y * height };
+		}
+
+		//triangles without uv area cover no texel centre
+		if (Vector2::Cross(triangle.uv[1] - triangle.uv[0], triangle.uv[2] - triangle.uv[0]) == 0.f)
+		{
+			continue;
+		}
+
+		triangle.minY = std::max(static_cast<int>(std::floor(std::min({ triangle.uv[0].y, triangle.uv[1].y, triangle.uv[2].y }) - 0.5f)), 0);
+		triangle.maxY = std::min(static_cast<int>(std::ceil(std::max({ triangle.uv[0].y, triangle.uv[1].y, triangle.uv[2].y }) - 0.5f)), height - 1);
+		triangles.push_back(triangle);
+	}
+
+	return triangles;
+}
+
+void NormalMapBaker::ForEachBand(int height, const std::function<void(int minY, int maxY)>& bandFunction)
+{
+	constexpr int bandHeight{ 16 };
+	std::vector<int> bands((height + bandHeight - 1) / bandHeight);
+	std::iota(bands.begin(), bands.end(), 0);
+
+	const Subsystem subsystem{ AllocationTracker::GetCurrentSubsystem() };
+	std::for_each(std::execution::par, bands.begin(), bands.end(), [&](int band)
+		{
+			const AllocationTracker::Scope allocationScope{ subsystem };
+			const int minY{ band * bandHeight };
+			bandFunction(minY, std::min(minY + bandHeight, height) - 1);
+		});
+}
+
+void NormalMapBaker::ForEachCoveredTexel(const UVTriangle& triangle, int minY, int maxY, int width, const std::function<void(int x, int y, const float (&weights)[3])>& texelFunction)
+{
+	if (minY > maxY)
+	{
+		return;
+	}
+
+	const Vector2& uv0{ triangle.uv[0] };
+	const Vector2& uv1{ triangle.uv[1] };
+	const Vector2& uv2{ triangle.uv[2] };
+	const int minX{ std::max(static_cast<int>(std::floor(std::min({ uv0.x, uv1.x, uv2.x }) - 0.5f)), 0) };
+	const int maxX{ std::min(static_cast<int>(std::ceil(std::max({ uv0.x, uv1.x, uv2.x }) - 0.5f)), width - 1) };
+	const float invArea{ 1.f / Vector2::Cross(uv1 - uv0, uv2 - uv0) };
+
+	for (int y{ minY }; y <= maxY; ++y)
+	{
+		for (int x{ minX }; x <= maxX; ++x)
+		{
+			//barycentric weights of the texel centre, the winding in uv space can go either way
+			const Vector2 centre{ x + 0.5f, y + 0.5f };
+			float weights[3]{};
+			weights[0] = Vector2::Cross(uv2 - uv1, centre - uv1) * invArea;
+			weights[1] = Vector2::Cross(uv0 - uv2, centre - uv2) * invArea;
+			weights[2] = 1.f - weights[0] - weights[1];
+			if (weights[0] < 0.f || weights[1] < 0.f || weights[2] < 0.f)
+			{
+				continue;
+			}
+
+			texelFunction(x, y, weights);
+		}
+	}
+}
+
+std::vector<int> NormalMapBaker::FindTexelOwners(const std::vector<Vertex_PosCol>& vertices, const std::vector<uint32_t>& indices, const std::vector<UVTriangle>& triangles, int width, int height)
+{
+	//triangles are ordered by their vertices sorted on position and uv, which stays the same whatever order the index buffer has
+	using VertexKey = std::array<float, 5>;
+	using TriangleKey = std::array<VertexKey, 3>;
+
+	std::vector<TriangleKey> keys(indices.size() / 3);
+	for (size_t triangleIdx{ 0 }; triangleIdx < keys.size(); ++triangleIdx)
+	{
+		for (int vertexIdx{ 0 }; vertexIdx < 3; ++vertexIdx)
+		{
+			const Vertex_PosCol& vertex{ vertices[indices[(triangleIdx * 3) + vertexIdx]] };
+			keys[triangleIdx][vertexIdx] = VertexKey{ vertex.position.x, vertex.position.y, vertex.position.z, vertex.uv.x, vertex.uv.y };
+		}
+		std::sort(keys[triangleIdx].begin(), keys[triangleIdx].end());
+	}
+
+	std::vector<int> owners(size_t(width) * height, -1);
+
+	ForEachBand(height, [&](int bandMinY, int bandMaxY)
+		{
+			for (const UVTriangle& triangle : triangles)
+			{
+				ForEachCoveredTexel(triangle, std::max(triangle.minY, bandMinY), std::min(triangle.maxY, bandMaxY), width, [&](int x, int y, const float (&)[3])
+					{
+						int& owner{ owners[size_t(x) + (size_t(y) * width)] };
+						if (owner < 0 || keys[triangle.triangleIdx] < keys[owner])
+						{
+							owner = static_cast<int>(triangle.triangleIdx);
+						}
+					});
+			}
+		});
+
+	return owners;
+}
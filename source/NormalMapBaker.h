@@ -0,0 +1,65 @@
+#pragma once
+#include <functional>
+
+namespace dae
+{
+	struct Vertex_PosCol;
+
+	// Bakes the tangent space normal map of a rigid mesh into an object space one at load time, so shading a pixel only rotates
+	// the sampled normal by the world matrix instead of building a tangent frame. Object space normals are stored octahedral,
+	// x and y as 16 bit unorm with x in the low half of the texel.
+	// Mirrored and repeated parts share uv space, a shared texel can only hold the normal of one of them. It holds the one of the
+	// triangle first in a fixed order, every other triangle gets a rotation from that triangle's object space frame into its own
+	class NormalMapBaker final
+	{
+	public:
+		// CONSTANTS
+		//texels around a uv island get the normals of its edge, more than the bilinear footprint of the level reaches
+		static constexpr int m_DilationTexels{ 4 };
+
+		// MEMBER FUNCTIONS
+		//one rotation per triangle, row vectors like every other matrix, identity for triangles that own their texels.
+		//Bake with the rotations of the same index buffer the mesh draws with, so every triangle finds its own rotation
+		static std::vector<Matrix> ComputeNormalRotations(const std::vector<Vertex_PosCol>& vertices, const std::vector<uint32_t>& indices, int width, int height);
+
+		//texels hold the RGBA8 tangent space normals of one level going in and the octahedral object space normals coming out
+		static void BakeObjectSpaceNormals(const std::vector<Vertex_PosCol>& vertices, const std::vector<uint32_t>& indices, const std::vector<Matrix>& rotations, std::vector<uint32_t>& texels, int width, int height);
+
+		static uint32_t EncodeOctahedral(const Vector3& normal);
+
+		//x and y in [0, 1] like they are stored, the result is not normalized so filtered values only pay for one normalization
+		static Vector3 DecodeOctahedral(float x, float y)
+		{
+			Vector3 normal{ (x * 2.f) - 1.f, (y * 2.f) - 1.f, 0.f };
+			normal.z = 1.f - std::abs(normal.x) - std::abs(normal.y);
+
+			//the lower hemisphere is folded over the diagonals of the square
+			const float fold{ std::max(-normal.z, 0.f) };
+			normal.x += normal.x >= 0.f ? -fold : fold;
+			normal.y += normal.y >= 0.f ? -fold : fold;
+
+			return normal;
+		}
+
+	private:
+		// MEMBER VARIABLES
+		//a triangle in texel space, with the rows it can cover
+		struct UVTriangle
+		{
+			Vector2 uv[3]{};
+			uint32_t triangleIdx{};
+			int minY{};
+			int maxY{};
+		};
+
+		// MEMBER FUNCTIONS
+		static std::vector<UVTriangle> SetupUVTriangles(const std::vector<Vertex_PosCol>& vertices, const std::vector<uint32_t>& indices, int width, int height);
+
+		//rows of texels are split in bands that run in parallel, so a texel is only ever written by one thread
+		static void ForEachBand(int height, const std::function<void(int minY, int maxY)>& bandFunction);
+		static void ForEachCoveredTexel(const UVTriangle& triangle, int minY, int maxY, int width, const std::function<void(int x, int y, const float (&weights)[3])>& texelFunction);
+
+		//index of the triangle that owns every texel, -1 where no triangle covers it
+		static std::vector<int> FindTexelOwners(const std::vector<Vertex_PosCol>& vertices, const std::vector<uint32_t>& indices, const std::vector<UVTriangle>& triangles, int width, int height);
+	};
+}
@@ -1,796 +1,2655 @@
-#include "pch.h"
-#include "Renderer.h"
-#include "Mesh.h"
-#include "Camera.h"
-#include "Texture.h"
-#include "EffectVehicle.h"
-#include "EffectFire.h"
-#include "Utils.h"
-#include <algorithm>
-#include <execution>
-
-//DirectX headers
-#include <dxgi.h>
-#include <d3d11.h>
-#include <d3dcompiler.h>
-#include <d3dx11effect.h>
-
-namespace dae {
-
-	Renderer::Renderer(SDL_Window* pWindow) :
-		m_pWindow(pWindow)
-	{
-		//Initialize
-		SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
-
-		//SOFTWARE
-		//Create Buffers
-		m_pFrontBuffer = SDL_GetWindowSurface(m_pWindow); 
-		m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
-		m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels; 
-
-		m_pDepthBufferPixels = new float[m_Width * m_Height]; 
-
-		//Initialize DirectX pipeline
-		const HRESULT result = InitializeDirectX();
-		if (result == S_OK)
-		{
-			m_IsInitialized = true;
-			std::cout << "DirectX is initialized and ready!\n";
-		}
-		else
-		{
-			std::cout << "DirectX initialization failed!\n";
-		}
-
-		//Make Camera
-		m_pCamera = new Camera{ {0.f, 0.f, -50.f}, 45.f, 0.1f, 1000.f, float(m_Width) / m_Height }; 
-
-		//Make Effects
-		m_pEffectVehicle = new EffectVehicle{ m_pDevice, L"Resources/DefaultShader.fx" };
-		m_pEffectFire = new EffectFire{ m_pDevice, L"Resources/FlatShader.fx" };
-
-		//Load Vehicle Textures
-		m_pDiffuseTexture = Texture::LoadTexture("Resources/vehicle_diffuse.png", m_pDevice);
-		m_pSpecularTexture = Texture::LoadTexture("Resources/vehicle_specular.png", m_pDevice);
-		m_pGlossinessTexture = Texture::LoadTexture("Resources/vehicle_gloss.png", m_pDevice);
-		m_pNormalTexture = Texture::LoadTexture("Resources/vehicle_normal.png", m_pDevice);
-		m_pFireTexture = Texture::LoadTexture("Resources/fireFX_diffuse.png", m_pDevice);
-
-		std::vector<Vertex_PosCol> vertices{};
-		std::vector<uint32_t> indices{};
-		const std::string fileNameVehicle{ "Resources/vehicle.obj" };
-		const std::string fileNameFire{ "Resources/fireFX.obj" };
-
-		//Vehicle OBJ
-		Utils::ParseOBJ(fileNameVehicle, vertices, indices);
-		Mesh* pMesh = m_pMeshObjects.emplace_back(new Mesh{ m_pDevice, vertices, indices, m_pEffectVehicle, true });
-		m_pEffectVehicle->SetDiffuseMap(m_pDiffuseTexture);
-		m_pEffectVehicle->SetSpecularMap(m_pSpecularTexture); 
-		m_pEffectVehicle->SetGlossinessMap(m_pGlossinessTexture);
-		m_pEffectVehicle->SetNormalMap(m_pNormalTexture); 
-
-		//Fire OBJ
-		vertices.clear(); 
-		indices.clear(); 
-
-		Utils::ParseOBJ(fileNameFire, vertices, indices);
-		pMesh = m_pMeshObjects.emplace_back(new Mesh{ m_pDevice, vertices, indices, m_pEffectFire, false });
-		m_pEffectFire->SetDiffuseMap(m_pFireTexture);
-
-		//Togglinng Info
-		PrintingInfo(); 
-	}
-
-	Renderer::~Renderer()
-	{
-		delete m_pCamera;
-		
-		for (auto mesh : m_pMeshObjects)
-		{
-			delete mesh;
-			mesh = nullptr;
-		}
-
-		delete m_pEffectVehicle;
-		delete m_pDiffuseTexture;
-		delete m_pSpecularTexture;
-		delete m_pGlossinessTexture;
-		delete m_pNormalTexture;
-		delete m_pFireTexture;
-		delete m_pEffectFire;
-		delete[] m_pDepthBufferPixels;
-
-		m_pRenderTargetView->Release(); 
-		m_pRenderTargetBuffer->Release(); 
-		m_pDepthStencilView->Release(); 
-		m_pDepthStencilBuffer->Release(); 
-		m_pSwapChain->Release(); 
-
-		if (m_pDeviceContext) 
-		{
-			m_pDeviceContext->ClearState(); 
-			m_pDeviceContext->Flush(); 
-			m_pDeviceContext->Release(); 
-		}
-
-		m_pDevice->Release();  
-
-		m_pEffectFire = nullptr;
-		m_pEffectVehicle = nullptr;
-		m_pCamera = nullptr;
-		m_pDiffuseTexture = nullptr;
-		m_pSpecularTexture = nullptr;
-		m_pGlossinessTexture = nullptr;
-		m_pNormalTexture = nullptr;
-		m_pFireTexture = nullptr;
-	}
-
-	void Renderer::Update(const Timer* pTimer)
-	{
-		m_pCamera->Update(pTimer); 
-		
-		//Variables
-		const float yaw{ (pTimer->GetElapsed() * 45.f) * TO_RADIANS }; 
-		const Matrix rotation{ Matrix::CreateRotationY(yaw) };
-
-		//Check if it needs to be rotating
-		if (m_IsRotating)
-		{
-			//Rotate Mesh
-			for (auto mesh : m_pMeshObjects)
-			{
-				mesh->RotateMesh(yaw);
-			}
-		}
-
-		//Set Camera Position
-		for (auto mesh : m_pMeshObjects)
-		{
-			mesh->SetCameraPosition(m_pCamera->GetCameraOrigin());
-		}
-	}
-
-	void Renderer::Render() const
-	{
-		if (!m_IsInitialized)
-			return;
-
-		if (m_RasterizerSettings == RasterizerSettings::hardware)
-		{
-			Render_Hardware();
-		}
-
-		if (m_RasterizerSettings == RasterizerSettings::software)
-		{
-			//@START
-			//Lock BackBuffer
-			SDL_LockSurface(m_pBackBuffer);
-			
-			Render_Software();
-
-			//@END
-			//Update SDL Surface
-			SDL_UnlockSurface(m_pBackBuffer);
-			SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0); 
-			SDL_UpdateWindowSurface(m_pWindow); 
-		}
-	}
-
-	// -----------------------------
-	//		  HARDWARE PART
-	// -----------------------------
-	void Renderer::Render_Hardware() const
-	{
-		//1. CLEAR RTV & DSV
-		constexpr float backgroundColor[4] = { 0.39f, 0.59f, 0.93f, 1.f };
-		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, backgroundColor);
-		m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
-
-		//2. SET PIPELINE + INVOKE DRAW CALLS (= RENDER)
-		const Matrix inverseViewMatrix = m_pCamera->GetInverseViewMatrix(); 
-		const Matrix projectionMatrix = m_pCamera->GetProjectionMatrix();
-
-		//first make view projection matrix
-		const Matrix worldViewProjectionMatrix{ m_pMeshObjects[0]->GetWorldMatrix() * inverseViewMatrix * projectionMatrix };
-		//Render Vehicle Mesh
-		m_pMeshObjects[0]->Render(m_pDeviceContext, worldViewProjectionMatrix); 
-
-		//Check if Fire Mesh needs to be visible
-		if (m_IsShowingFireMesh)
-		{
-			//first make view projection matrix
-			const Matrix worldViewProjectionMatrix{ m_pMeshObjects[1]->GetWorldMatrix() * inverseViewMatrix * projectionMatrix }; 
-			//Render Fire Mesh
-			m_pMeshObjects[1]->Render(m_pDeviceContext, worldViewProjectionMatrix); 
-		}
-
-		//3. PRESENT BACKBUFFER (SWAP)
-		m_pSwapChain->Present(0, 0);
-	}
-
-	HRESULT Renderer::InitializeDirectX()
-	{
-		//1. Create Device & Device Context
-		//=====
-		D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_1;
-		uint32_t createDeviceFlags = 0;
-#if defined(DEBUG) || defined(_DEBUG)
-		// |=  -->  bitwise OR operator combined with assignment
-		//createDeviceFlags = createDeviceFlags | D3D11_CREATE_DEVICE_DEBUG;
-		createDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
-#endif
-		HRESULT result = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, 0, createDeviceFlags, &featureLevel, 1, D3D11_SDK_VERSION,
-			&m_pDevice, nullptr, &m_pDeviceContext);
-		if (FAILED(result))
-		{
-			return result;
-		}
-
-		//Create DXGI Factory
-		IDXGIFactory1* pDxgiFactory{};
-		//void** --> represents pointer to location that stored another pointer to void
-		result = CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**>(&pDxgiFactory));
-		if (FAILED(result))
-		{
-			return result;
-		}
-
-		//2. Create Swapchain
-		//=====
-		DXGI_SWAP_CHAIN_DESC swapChainDesc{};
-		swapChainDesc.BufferDesc.Width = m_Width;
-		swapChainDesc.BufferDesc.Height = m_Height;
-		swapChainDesc.BufferDesc.RefreshRate.Numerator = 1;
-		swapChainDesc.BufferDesc.RefreshRate.Denominator = 60;
-		swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-		swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-		swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-		swapChainDesc.SampleDesc.Count = 1;
-		swapChainDesc.SampleDesc.Quality = 0;
-		swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-		swapChainDesc.BufferCount = 1;
-		swapChainDesc.Windowed = true;
-		swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
-		swapChainDesc.Flags = 0;
-
-		//Get the handle (HWND) from the SDL backbuffer
-		SDL_SysWMinfo sysWMInfo{};
-		SDL_GetVersion(&sysWMInfo.version);
-		SDL_GetWindowWMInfo(m_pWindow, &sysWMInfo);
-		swapChainDesc.OutputWindow = sysWMInfo.info.win.window;
-
-		//Create SwapChain
-		result = pDxgiFactory->CreateSwapChain(m_pDevice, &swapChainDesc, &m_pSwapChain);
-		if (FAILED(result))
-		{
-			return result;
-		}
-
-		//3. Create DepthStencil (DS) and DepthStencilView (DSV)
-		//=====
-		D3D11_TEXTURE2D_DESC depthStencilDesc{};
-		depthStencilDesc.Width = m_Width;
-		depthStencilDesc.Height = m_Height;
-		depthStencilDesc.MipLevels = 1;
-		depthStencilDesc.ArraySize = 1;
-		depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-		depthStencilDesc.SampleDesc.Count = 1;
-		depthStencilDesc.SampleDesc.Quality = 0;
-		depthStencilDesc.Usage = D3D11_USAGE_DEFAULT;
-		depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
-		depthStencilDesc.CPUAccessFlags = 0;
-		depthStencilDesc.MiscFlags = 0;
-
-		//View
-		D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
-		depthStencilViewDesc.Format = depthStencilDesc.Format;
-		depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
-		depthStencilViewDesc.Texture2D.MipSlice = 0;
-
-		result = m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer);
-		if (FAILED(result))
-		{
-			return result;
-		}
-
-		result = m_pDevice->CreateDepthStencilView(m_pDepthStencilBuffer, &depthStencilViewDesc, &m_pDepthStencilView);
-		if (FAILED(result))
-		{
-			return result;
-		}
-
-		//4. Create RenderTarget (RT) & RenderTargetView (RTV)
-		//=====
-
-		//Resource
-		result = m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&m_pRenderTargetBuffer));
-		if (FAILED(result))
-		{
-			return result;
-		}
-
-		//View
-		result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer, nullptr, &m_pRenderTargetView);
-		if (FAILED(result))
-		{
-			return result;
-		}
-
-		//5. Bind RTV & DSV to Output Merger Stage
-		//=====
-		m_pDeviceContext->OMSetRenderTargets(1, &m_pRenderTargetView, m_pDepthStencilView);
-
-		//6. Set Viewport
-		//=====
-		D3D11_VIEWPORT viewport{};
-		viewport.Width = static_cast<float>(m_Width);
-		viewport.Height = static_cast<float>(m_Height);
-		viewport.TopLeftX = 0.f;
-		viewport.TopLeftY = 0.f;
-		viewport.MinDepth = 0.f;
-		viewport.MaxDepth = 1.f;
-		m_pDeviceContext->RSSetViewports(1, &viewport);
-
-		return result;
-
-		//hidden resource leak of DXGI factory
-		pDxgiFactory->Release();
-	}
-
-	// -----------------------------
-	//		  TOGGLING PART
-	// -----------------------------
-
-	// Not const because otherwise i cannnot change the SamplerState
-	void Renderer::ToggleSamplerState()
-	{
-		if (m_RasterizerSettings == RasterizerSettings::hardware)
-		{
-			for (auto mesh : m_pMeshObjects)
-			{
-				mesh->ToggleSamplerState();
-			}
-
-			//Sampler State to check what I need to print out
-			switch (m_Samples)
-			{
-			case SamplerStates::point:
-				m_Samples = SamplerStates::linear;
-				std::cout << "Sampling Filter: D3D11_FILTER_MIN_MAG_MIP_LINEAR" << std::endl;
-				break;
-
-			case SamplerStates::linear:
-				m_Samples = SamplerStates::anisotropic;
-				std::cout << "Sampling Filter: D3D11_FILTER_MIN_MAG_MIP_ANISOTROPIC" << std::endl;
-				break;
-
-			case SamplerStates::anisotropic:
-				m_Samples = SamplerStates::point;
-				std::cout << "Sampling Filter: D3D11_FILTER_MIN_MAG_MIP_POINT" << std::endl;
-				break;
-			}
-		}
-	}
-
-	void Renderer::ToggleShadingModes()
-	{
-		if (m_RasterizerSettings == RasterizerSettings::software)
-		{
-			const int amountOfShadingModes{ 4 }; 
-
-			int temp{ static_cast<int>(m_ShadingMode) }; 
-			m_ShadingMode = static_cast<ShadingModes>((++temp) % amountOfShadingModes); 
-
-			switch (m_ShadingMode)
-			{
-			case dae::Renderer::ShadingModes::cosineLambert:
-				std::cout << "Render Mode: Cosine Lambert Mode" << std::endl;
-				break;
-			case dae::Renderer::ShadingModes::diffuseLambert:
-				std::cout << "Render Mode: Diffuse Lambert Mode" << std::endl;
-				break;
-			case dae::Renderer::ShadingModes::specularPhong:
-				std::cout << "Render Mode: Specular Phong Mode" << std::endl;
-				break;
-			case dae::Renderer::ShadingModes::combined:
-				std::cout << "Render Mode: Combined Mode" << std::endl;
-				break;
-			}
-		}
-	}
-
-	void Renderer::ToggleRotation()
-	{
-		m_IsRotating = !m_IsRotating;
-	}
-
-	void Renderer::ToggleNormalMap()
-	{
-		for (auto mesh : m_pMeshObjects)
-		{
-			mesh->ToggleNormalMap(); 
-		}
-
-		m_IsNormalMapOn = !m_IsNormalMapOn;
-
-		if (m_IsNormalMapOn)
-		{
-			std::cout << "Sample normal map: ON\n";
-		}
-		else
-		{
-			std::cout << "Sample normal map: OFF\n";
-		}
-	}
-
-	void Renderer::ToggleFireMesh()
-	{
-		if (m_RasterizerSettings == RasterizerSettings::hardware)
-		{
-			m_IsShowingFireMesh = !m_IsShowingFireMesh;
-		}
-	}
-
-	void Renderer::ToggleRenderingSettings()
-	{
-		switch (m_RasterizerSettings)
-		{
-		case Renderer::RasterizerSettings::software:
-			m_RasterizerSettings = RasterizerSettings::hardware;
-			std::cout << "Render setting: Hardware" << std::endl;
-			break;
-		case Renderer::RasterizerSettings::hardware:
-			m_RasterizerSettings = RasterizerSettings::software;
-			std::cout << "Render setting: Software" << std::endl;
-			break;
-		default:
-
-			break;
-		}
-	}
-
-	void Renderer::ToggleRenderModes()
-	{
-		if (m_RasterizerSettings == RasterizerSettings::software)
-		{
-			const int amountOfRenderModes{ 2 }; 
-
-			int temp{ static_cast<int>(m_RenderMode) }; 
-			m_RenderMode = static_cast<RenderMode>((++temp) % amountOfRenderModes); 
-		}
-	}
-
-	// -----------------------------
-	//		  SOFTWARE PART
-	// -----------------------------
-	void Renderer::Render_Software() const
-	{
-		//From World to View to Projection to Screen space
-		VertexTransformationFunction(m_pMeshObjects);
-
-		std::fill_n(m_pDepthBufferPixels, m_Width * m_Height, FLT_MAX);
-
-		//Clear back buffer
-		SDL_FillRect(m_pBackBuffer, &m_pBackBuffer->clip_rect, SDL_MapRGB(m_pBackBuffer->format, 100, 100, 100));
-
-		for (Mesh* pMesh : m_pMeshObjects) 
-		{
-			// Check if Mesh needs to be loaded in Software mode
-			if (pMesh->GetIsInSoftwareMode()) 
-			{
-				if (pMesh->GetPrimitiveTopology() == PrimitiveTopology::TriangleList)
-				{
-					const auto& meshIndices = pMesh->GetMeshIndices();
-					const auto& meshVerticesOut = pMesh->GetMeshVerticesOut();
-
-					// Assuming GetMeshIndices() always contains a multiple of 3 indices
-					for (size_t triangleIdx = 0; triangleIdx < meshIndices.size(); triangleIdx += 3) 
-					{
-						const Vertex_Out& v0 = meshVerticesOut[meshIndices[triangleIdx + 0]]; 
-						const Vertex_Out& v1 = meshVerticesOut[meshIndices[triangleIdx + 1]]; 
-						const Vertex_Out& v2 = meshVerticesOut[meshIndices[triangleIdx + 2]]; 
-
-						//go over triangle, per 3 vertices
-						TriangleHandeling(v0, v1, v2, pMesh);
-					}
-				}
-			}
-		}
-	}
-
-	void Renderer::VertexTransformationFunction(const std::vector<Mesh*>& meshes_in) const
-	{
-		for (Mesh* pMesh : meshes_in)
-		{
-			const Matrix worldMatrix{ pMesh->GetWorldMatrix() };
-			const Matrix worldViewProjectionMatrix{ worldMatrix * m_pCamera->GetViewMatrix() * m_pCamera->GetProjectionMatrix() }; 
-
-			pMesh->GetMeshVerticesOut().clear();
-			auto& meshVerticesOut = pMesh->GetMeshVerticesOut();
-			meshVerticesOut.reserve(pMesh->GetMeshVertices().size());
-
-			for (Vertex_PosCol& vertice : pMesh->GetMeshVertices()) 
-			{
-				Vector4 transformedPosition{ worldViewProjectionMatrix.TransformPoint(Vector4{vertice.position, 1.f}) };
-
-				//first was overriding vertices normal & tangent
-				//making temp variable instead 
-				const Vector3 newNormal{ worldMatrix.TransformVector(vertice.normal).Normalized() }; 
-				const Vector3 newTangent{ worldMatrix.TransformVector(vertice.tangent).Normalized() }; 
-				const Vector3 newViewDirection{ worldMatrix.TransformVector(vertice.position) - m_pCamera->GetCameraOrigin() };
-
-				//model to NDC space
-				transformedPosition.x /= transformedPosition.w; 
-				transformedPosition.y /= transformedPosition.w; 
-				transformedPosition.z /= transformedPosition.w; 
-				 
-				//projection to screen space
-				transformedPosition.x = ((transformedPosition.x + 1.f) / 2.f) * m_Width;
-				transformedPosition.y = ((1.f - transformedPosition.y) / 2.f) * m_Height;
-
-				Vertex_Out& vertex_out{ pMesh->GetMeshVerticesOut().emplace_back(Vertex_Out{})};
-				vertex_out.position = transformedPosition;
-				vertex_out.color = vertice.color;
-				vertex_out.uv = vertice.uv;
-				vertex_out.normal = newNormal;
-				vertex_out.tangent = newTangent;
-				vertex_out.viewDirection = newViewDirection;
-			}
-		}
-	}
-
-	void Renderer::TriangleHandeling(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, Mesh* mesh_transformed) const
-	{
-		//frustum culling
-		if (v0.position.x < 0 || v0.position.x > m_Width || v0.position.y < 0 || v0.position.y > m_Height ||
-			v1.position.x < 0 || v1.position.x > m_Width || v1.position.y < 0 || v1.position.y > m_Height ||
-			v2.position.x < 0 || v2.position.x > m_Width || v2.position.y < 0 || v2.position.y > m_Height)
-		{
-			return;
-		}
-
-		//precompute constants
-		const Vector2 v2_v1{ v2.position.GetXY() - v1.position.GetXY() };
-		const Vector2 v0_v2{ v0.position.GetXY() - v2.position.GetXY() };
-		const Vector2 v1_v0{ v1.position.GetXY() - v0.position.GetXY() };
-
-		//scale to increase bounding box size -> no lines between triangles/quads
-		const float boundingBoxScale{ 5.f };
-
-		//calculate min & max x of bounding box, clamped to screen
-		const float topLeftX{ std::min({v0.position.x, v1.position.x, v2.position.x}) };
-		const float topLeftY{ std::min({v0.position.y, v1.position.y, v2.position.y}) };
-		const int minX{ Clamp(static_cast<int>(topLeftX - boundingBoxScale), 0, m_Width) };
-		const int minY{ Clamp(static_cast<int>(topLeftY - boundingBoxScale), 0, m_Height) };
-
-		//calculate min & max y of bounding box, clamped to screen
-		const float bottomRightX{ std::max({v0.position.x, v1.position.x, v2.position.x}) };
-		const float bottomRightY{ std::max({v0.position.y, v1.position.y, v2.position.y}) };
-		const int maxX{ Clamp(static_cast<int>(bottomRightX + boundingBoxScale), 0, m_Width) };
-		const int maxY{ Clamp(static_cast<int>(bottomRightY + boundingBoxScale), 0, m_Height) };
-
-		const Vector2 v0_xy = v0.position.GetXY();
-		const Vector2 v1_xy = v1.position.GetXY();
-		const Vector2 v2_xy = v2.position.GetXY(); 
-
-		//go over each pixel is in screen space
-		for (int px{ minX }; px < maxX; ++px)
-		{
-			for (int py{ minY }; py < maxY; ++py)
-			{
-				//define current pixel in screen space
-				const Vector2 p{ px + 0.5f, py + 0.5f };
-
-				float w0{ Vector2::Cross(v2_v1, p - v1_xy) };
-				float w1{ Vector2::Cross(v0_v2, p - v2_xy) };
-				float w2{ Vector2::Cross(v1_v0, p - v0_xy) };
-
-				if (w0 >= 0.f && w1 >= 0.f && w2 >= 0.f)
-				{
-					ProcessRenderedTriangle(v0, v1, v2, w0, w1, w2, px, py);
-				}
-			}
-		}
-	}
-
-	void Renderer::ProcessRenderedTriangle(const Vertex_Out v0, const Vertex_Out v1, const Vertex_Out v2, float w0, float w1, float w2, int px, int py) const
-	{
-		//variables
-		const int bufferIdx{ px + (py * m_Width) };
-		ColorRGB finalColour{ 0.f, 0.f, 0.f };
-
-		//using right formula, see slides, has performance gain too
-		const float triangleArea{ w0 + w1 + w2 };
-		const float invTriangleArea{ 1.f / triangleArea };
-
-		//normalize weights
-		w0 *= invTriangleArea;
-		w1 *= invTriangleArea;
-		w2 *= invTriangleArea;
-
-		//depth buffer -> only for comparing depth values; are not linear
-		const float invVerticeZ0{ (1.f / v0.position.z) * w0 };
-		const float invVerticeZ1{ (1.f / v1.position.z) * w1 };
-		const float invVerticeZ2{ (1.f / v2.position.z) * w2 };
-		//used for comparison in depth test and value we store in depth buffer
-		float zBufferValue{ 1.f / (invVerticeZ0 + invVerticeZ1 + invVerticeZ2) };
-
-		//check if value is in range of [0,1]
-		if (0.f > zBufferValue || zBufferValue > 1.f)
-		{
-			return;
-		}
-
-		if (zBufferValue <= m_pDepthBufferPixels[bufferIdx])
-		{
-			m_pDepthBufferPixels[bufferIdx] = zBufferValue;
-
-			//intepolate vertex attributes with correct depth
-			const float invVerticeW0{ (1.f / v0.position.w) * w0 };
-			const float invVerticeW1{ (1.f / v1.position.w) * w1 };
-			const float invVerticeW2{ (1.f / v2.position.w) * w2 };
-			float wInterpolated{ 1.f / (invVerticeW0 + invVerticeW1 + invVerticeW2) };
-
-			//calculate interpolated uv coordinates
-			const Vector2 invUV0{ (v0.uv / v0.position.w) * w0 };
-			const Vector2 invUV1{ (v1.uv / v1.position.w) * w1 };
-			const Vector2 invUV2{ (v2.uv / v2.position.w) * w2 };
-			Vector2 interpolatedUV{ (invUV0 + invUV1 + invUV2) * wInterpolated };
-
-			//clamp interpolated uv value between [0, 1]
-			interpolatedUV.x = Clamp(interpolatedUV.x, 0.f, 1.f);
-			interpolatedUV.y = Clamp(interpolatedUV.y, 0.f, 1.f);
-
-			//calculate interpolated colour coordinates
-			const ColorRGB invColour0{ (v0.color / v0.position.w) * w0 };
-			const ColorRGB invColour1{ (v1.color / v1.position.w) * w1 };
-			const ColorRGB invColour2{ (v2.color / v2.position.w) * w2 };
-			ColorRGB interpolatedColour{ (invColour0 + invColour1 + invColour2) * wInterpolated };
-
-			//calculate interpolated normal coordinates
-			const Vector3 invNormal0{ (v0.normal / v0.position.w) * w0 };
-			const Vector3 invNormal1{ (v1.normal / v1.position.w) * w1 };
-			const Vector3 invNormal2{ (v2.normal / v2.position.w) * w2 };
-			Vector3 interpolatedNormal{ (invNormal0 + invNormal1 + invNormal2) * wInterpolated };
-
-			//calculate interpolated tangent coordinates
-			const Vector3 invTangent0{ (v0.tangent / v0.position.w) * w0 };
-			const Vector3 invTangent1{ (v1.tangent / v1.position.w) * w1 };
-			const Vector3 invTangent2{ (v2.tangent / v2.position.w) * w2 };
-			Vector3 interpolatedTangent{ (invTangent0 + invTangent1 + invTangent2) * wInterpolated };
-
-			//calculate interpolated viewDirection coordinates
-			const Vector3 invViewDirection0{ (v0.viewDirection / v0.position.w) * w0 };
-			const Vector3 invViewDirection1{ (v1.viewDirection / v1.position.w) * w1 };
-			const Vector3 invViewDirection2{ (v2.viewDirection / v2.position.w) * w2 };
-			Vector3 interpolatedViewDirection{ (invViewDirection0 + invViewDirection1 + invViewDirection2) * wInterpolated };
-
-			Vertex_Out vertexOut{};
-			vertexOut.uv = interpolatedUV;
-			vertexOut.color = interpolatedColour;
-			vertexOut.normal = interpolatedNormal.Normalized();
-			vertexOut.tangent = interpolatedTangent.Normalized();
-			vertexOut.viewDirection = interpolatedViewDirection.Normalized();
-
-			switch (m_RenderMode)
-			{
-			case RenderMode::finalColour:
-				finalColour = PixelShading(vertexOut);
-				break;
-			case RenderMode::depthBuffer:
-				zBufferValue = Remap(zBufferValue, 0.995f, 1.f);
-				finalColour = ColorRGB{ zBufferValue, zBufferValue, zBufferValue };
-				break;
-			}
-
-			finalColour.MaxToOne();
-
-			m_pBackBufferPixels[px + (py * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
-				static_cast<uint8_t>(finalColour.r * 255),
-				static_cast<uint8_t>(finalColour.g * 255),
-				static_cast<uint8_t>(finalColour.b * 255));
-		}
-	}
-
-	float Renderer::Remap(float value, float inputMin, float inputMax) const
-	{
-		const float temp{ (value - inputMin) / (inputMax - inputMin) }; 
-		return temp; 
-	}
-
-	ColorRGB Renderer::PixelShading(const Vertex_Out& v) const
-	{
-		//const variables
-		const ColorRGB ambient{ 0.03f, 0.03f , 0.03f };
-		const Vector3 lightDirection{ 0.577f, -0.577f, 0.577f };
-		const float lightIntensity{ 7.f };
-		const float diffuseCoeffient{ 1.f };
-		const float shininess{ 25.f };
-
-		//variables
-		float observedArea{};
-		ColorRGB finalColour{};
-
-		//sample texture maps
-		const ColorRGB diffuseColour{ m_pDiffuseTexture->Sample(v.uv) }; 
-		const ColorRGB glossColour{ m_pGlossinessTexture->Sample(v.uv) }; 
-		const ColorRGB normalTextureSample{ m_pNormalTexture->Sample(v.uv) }; 
-		const ColorRGB specularColour{ m_pSpecularTexture->Sample(v.uv) }; 
-
-		//create tangent space transformation matrix
-		const Vector3 binormal{ Vector3::Cross(v.normal, v.tangent) };
-		const Matrix tangentSpaceAxis{ v.tangent, binormal, v.normal, Vector3{0.f, 0.f, 0.f} };
-
-		// Sample from normal map and multiply it with the matrix
-		Vector3 sampledNormal = tangentSpaceAxis.TransformVector((Vector3(normalTextureSample.r, normalTextureSample.g, normalTextureSample.b) * 2.f) - 
-																  Vector3{ 1.f, 1.f, 1.f }).Normalized();
-
-		// Calculate observed area
-		if (m_IsNormalMapOn)
-		{
-			//observed area
-			observedArea = Vector3::Dot(sampledNormal, -lightDirection);
-		}
-		else
-		{
-			//observed area
-			observedArea = Vector3::Dot(v.normal, -lightDirection);
-		}
-
-		if (observedArea <= 0)
-		{
-			return ColorRGB{ 0.f, 0.f, 0.f };
-		}
-
-		//shading mode calculations
-		const ColorRGB exponent{ glossColour * shininess };
-
-		//calculate lambert diffuse
-		const ColorRGB lambertDiffuse{ (diffuseCoeffient * diffuseColour) / float(M_PI) };
-
-		//calculate phong reflection
-		const Vector3 reflect{ lightDirection - (2.f * Vector3::Dot(sampledNormal, lightDirection) * sampledNormal) };
-		const float angle{ std::max(0.f, Vector3::Dot(reflect, -v.viewDirection)) };
-		const ColorRGB specular{ specularColour * std::powf(angle, exponent.r) };
-
-		switch (m_ShadingMode)
-		{
-		case ShadingModes::cosineLambert:  
-			finalColour = ColorRGB{ observedArea, observedArea, observedArea }; 
-			break;
-		case ShadingModes::diffuseLambert:
-			finalColour = lightIntensity * lambertDiffuse * observedArea; 
-			break;
-		case ShadingModes::specularPhong:  
-			finalColour = specular * observedArea; 
-			break;
-		case ShadingModes::combined: 
-			finalColour = ((lambertDiffuse * lightIntensity) + specular + ambient) * observedArea; 
-			break;
-		}
-
-		return finalColour;
-	}
-
-	// -----------------------------
-	//		PRINTING INFO PART
-	// -----------------------------
-	void Renderer::PrintingInfo() const
-	{
-		std::cout << "" << std::endl;
-		
-		std::cout << RED_COLOR_TEXT << "[KEY BINDINGS - SHARED]" << std::endl;  
-		std::cout << "\t [F1] Toggle Rasterizing Settings (HARDWARE/SOFTWARE)" << std::endl; 
-		std::cout << "\t [F5] Toggle Rotation (ON/OFF)" << std::endl; 
-		std::cout << "\t [F6] Toggle Normal Map (ON/OFF)" << RESET_COLOR_TEXT << std::endl << std::endl; 
-
-		std::cout << BLUE_COLOR_TEXT << "[KEY BINDINGS - HARDWARE]" << std::endl; 
-		std::cout << "\t [F4] Cycle Sampler State (POINT/LINEAR/ANISOTROPIC)" << std::endl;
-		std::cout << "\t [F7] Toggle FireFX (ON/OFF)" << RESET_COLOR_TEXT << std::endl << std::endl; 
-
-		std::cout << GREEN_COLOR_TEXT << "[KEY BINDINGS - SOFTWARE]" << std::endl;
-		std::cout << "\t [F2] Cycle Shading Modes (COMBINED/OBSERVED AREA/DIFFUSE/SPECULAR)" << std::endl;
-		std::cout << "\t [F3] Toggle Render Modes (FINAL COLOUR/DEPTH BUFFER)" << RESET_COLOR_TEXT << std::endl << std::endl; 
-	}
+#include "pch.h"
+#include "Renderer.h"
+#include "Mesh.h"
+#include "Camera.h"
+#include "Texture.h"
+#include "MaterialTexture.h"
+#include "NormalMapBaker.h"
+#include "SpecularPower.h"
+#include "CpuFeatures.h"
+#include "FrameArena.h"
+#include "AllocationTracker.h"
+#include "EffectVehicle.h"
+#include "EffectFire.h"
+#include "Utils.h"
+#include <algorithm>
+#include <execution>
+#include <bit>
+#include <cassert>
+#include <immintrin.h>
+
+//DirectX headers
+#include <dxgi.h>
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#include <d3dx11effect.h>
+
+namespace dae {
+
+	//defined here, the header only forward declares Vertex_PosCol
+	struct Renderer::VehicleGeometry
+	{
+		std::vector<Vertex_PosCol> vertices{};
+		std::vector<uint32_t> indices{};
+		std::vector<Matrix> normalRotations{};
+	};
+
+	Renderer::Renderer(SDL_Window* pWindow, InstructionSet instructionSetLimit) :
+		m_pWindow(pWindow)
+	{
+		const AllocationTracker::Scope allocationScope{ Subsystem::renderer };
+
+		//Initialize
+		SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+
+		//Select the instruction set before any texture is decoded, every kernel dispatches on it from here on
+		const InstructionSet instructionSet{ CpuFeatures::SelectInstructionSet(instructionSetLimit) };
+		switch (instructionSet)
+		{
+		case InstructionSet::avx512:
+			m_FastestRasterizerKernel = RasterizerKernel::avx512;
+			break;
+		case InstructionSet::avx2:
+			m_FastestRasterizerKernel = RasterizerKernel::avx2;
+			break;
+		case InstructionSet::baseline:
+			m_FastestRasterizerKernel = RasterizerKernel::scalar;
+			break;
+		}
+		m_RasterizerKernel = m_FastestRasterizerKernel;
+
+		std::cout << "Instruction set: " << GetInstructionSetName(instructionSet) << " (CPU supports " << GetInstructionSetName(CpuFeatures::GetSupportedInstructionSet())
+			<< ", limit " << GetInstructionSetName(instructionSetLimit) << ")" << std::endl;
+
+		//SOFTWARE
+		//Create Buffers
+		m_pFrontBuffer = SDL_GetWindowSurface(m_pWindow); 
+		m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
+		m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels; 
+
+		//Resolve the back buffer format once, every channel is a full byte
+		const SDL_PixelFormat* pFormat{ m_pBackBuffer->format };
+		assert(pFormat->BytesPerPixel == 4 && pFormat->Rloss == 0 && pFormat->Gloss == 0 && pFormat->Bloss == 0);
+		m_OutputFormat.redShift = pFormat->Rshift;
+		m_OutputFormat.greenShift = pFormat->Gshift;
+		m_OutputFormat.blueShift = pFormat->Bshift;
+		m_OutputFormat.alphaMask = pFormat->Amask;
+
+		m_SRGBTable.resize(m_SRGBTableSize);
+		for (int idx{ 0 }; idx < m_SRGBTableSize; ++idx)
+		{
+			const float linear{ idx / float(m_SRGBTableSize - 1) };
+			const float encoded{ linear <= 0.0031308f ? linear * 12.92f : (1.055f * std::powf(linear, 1.f / 2.4f)) - 0.055f };
+			m_SRGBTable[idx] = static_cast<int>((encoded * 255.f) + 0.5f);
+		}
+
+		//Split the screen in tiles, each tile owns one contiguous block of the colour and depth buffers
+		m_AmountOfTilesX = (m_Width + m_TileSize - 1) / m_TileSize;
+		m_AmountOfTilesY = (m_Height + m_TileSize - 1) / m_TileSize;
+
+		const int amountOfTilePixels{ m_AmountOfTilesX * m_AmountOfTilesY * m_TileSize * m_TileSize };
+		m_pColourBufferPixels = new uint32_t[amountOfTilePixels];
+		m_pDepthBufferPixels = new float[amountOfTilePixels]; 
+		m_pVisibilityBufferPixels = new uint32_t[amountOfTilePixels];
+
+		m_Tiles.resize(m_AmountOfTilesX * m_AmountOfTilesY);
+		for (int tileY{ 0 }; tileY < m_AmountOfTilesY; ++tileY)
+		{
+			for (int tileX{ 0 }; tileX < m_AmountOfTilesX; ++tileX)
+			{
+				const int tileIdx{ tileX + (tileY * m_AmountOfTilesX) };
+
+				Tile& tile{ m_Tiles[tileIdx] };
+				tile.minX = tileX * m_TileSize;
+				tile.minY = tileY * m_TileSize;
+				tile.maxX = std::min(tile.minX + m_TileSize, m_Width);
+				tile.maxY = std::min(tile.minY + m_TileSize, m_Height);
+				tile.pColourPixels = m_pColourBufferPixels + (tileIdx * m_TileSize * m_TileSize);
+				tile.pDepthPixels = m_pDepthBufferPixels + (tileIdx * m_TileSize * m_TileSize);
+				tile.pVisibilityPixels = m_pVisibilityBufferPixels + (tileIdx * m_TileSize * m_TileSize);
+			}
+		}
+
+		//Guard band in clip space, never smaller than the screen itself
+		m_GuardBandX = std::max(1.f, m_GuardBandPixels / (m_Width * 0.5f));
+		m_GuardBandY = std::max(1.f, m_GuardBandPixels / (m_Height * 0.5f));
+
+		//Specular table for the shininess both pixel shaders use
+		m_pSpecularPower = new SpecularPower{ m_Shininess };
+
+		//Transient software frame data
+		m_pFrameArena = new FrameArena{ m_FrameArenaBytes };
+
+		//Initialize DirectX pipeline
+		const HRESULT result = InitializeDirectX();
+		if (result == S_OK)
+		{
+			m_IsInitialized = true;
+			std::cout << "DirectX is initialized and ready!\n";
+		}
+		else
+		{
+			std::cout << "DirectX initialization failed!\n";
+		}
+
+		//Make Camera
+		m_pCamera = new Camera{ {0.f, 0.f, -50.f}, 45.f, 0.1f, 1000.f, float(m_Width) / m_Height }; 
+
+		//Make Effects
+		m_pEffectVehicle = new EffectVehicle{ m_pDevice, L"Resources/DefaultShader.fx" };
+		m_pEffectFire = new EffectFire{ m_pDevice, L"Resources/FlatShader.fx" };
+
+		//Load Vehicle Textures
+		//Rendering starts on the GPU, the software path loads what it needs again the first time it is switched to
+		m_pDiffuseTexture = Texture::LoadTexture("Resources/vehicle_diffuse.png", TextureFormat::bc1, Residency::gpuOnly, m_pDevice);
+		m_pSpecularTexture = Texture::LoadTexture("Resources/vehicle_specular.png", TextureFormat::bc4, Residency::gpuOnly, m_pDevice);
+		m_pGlossinessTexture = Texture::LoadTexture("Resources/vehicle_gloss.png", TextureFormat::bc4, Residency::gpuOnly, m_pDevice);
+		m_pFireTexture = Texture::LoadTexture("Resources/fireFX_diffuse.png", TextureFormat::bc3, Residency::gpuOnly, m_pDevice);
+
+		//The vehicle is parsed and optimized once, the normal map bake and the mesh use the same triangles and rotations
+		m_pVehicleGeometry = new VehicleGeometry{};
+		LoadVehicleGeometry(m_pVehicleGeometry->vertices, m_pVehicleGeometry->indices);
+
+		//The vehicle is rigid, so its normal map is baked to object space once and stored like the other blocks
+		TextureBake normalBake{};
+		normalBake.sourcePath = m_VehicleMeshPath;
+		normalBake.bakeLevels = [this](const MipChain& mipChain, std::vector<std::vector<uint32_t>>& levels)
+			{
+				//a bake that runs after the constructor, when the CPU copy of the map is loaded again, loads its own geometry
+				VehicleGeometry loadedGeometry{};
+				VehicleGeometry& geometry{ m_pVehicleGeometry != nullptr ? *m_pVehicleGeometry : loadedGeometry };
+				if (geometry.vertices.empty())
+				{
+					LoadVehicleGeometry(geometry.vertices, geometry.indices);
+				}
+
+				//texels shared by several triangles are owned at the resolution of the first level on every level
+				geometry.normalRotations = NormalMapBaker::ComputeNormalRotations(geometry.vertices, geometry.indices, mipChain.GetLevel(0).width, mipChain.GetLevel(0).height);
+
+				for (int level{ 0 }; level < mipChain.GetAmountOfLevels(); ++level)
+				{
+					const MipChain::MipLevel& mip{ mipChain.GetLevel(level) };
+					NormalMapBaker::BakeObjectSpaceNormals(geometry.vertices, geometry.indices, geometry.normalRotations, levels[level], mip.width, mip.height);
+				}
+			};
+		m_pNormalTexture = Texture::LoadTexture("Resources/vehicle_normal.png", TextureFormat::rg16, Residency::gpuOnly, m_pDevice, normalBake);
+		m_pVehicleMaterial = nullptr;
+
+		//The bake only runs when the baked blocks are out of date
+		if (m_pVehicleGeometry->normalRotations.empty())
+		{
+			m_pVehicleGeometry->normalRotations = NormalMapBaker::ComputeNormalRotations(m_pVehicleGeometry->vertices, m_pVehicleGeometry->indices, m_pNormalTexture->GetWidth(), m_pNormalTexture->GetHeight());
+		}
+
+		//Vehicle OBJ
+		Mesh* pMesh = m_pMeshObjects.emplace_back(new Mesh{ m_pDevice, m_pVehicleGeometry->vertices, m_pVehicleGeometry->indices, m_pEffectVehicle, true, Residency::gpuOnly });
+		pMesh->CreateNormalRotationBuffer(m_pDevice, m_pVehicleGeometry->normalRotations);
+
+		//Only the GPU copies stay, the software path loads the vehicle again the first time it needs it
+		delete m_pVehicleGeometry;
+		m_pVehicleGeometry = nullptr;
+
+		m_pEffectVehicle->SetDiffuseMap(m_pDiffuseTexture);
+		m_pEffectVehicle->SetSpecularMap(m_pSpecularTexture); 
+		m_pEffectVehicle->SetGlossinessMap(m_pGlossinessTexture);
+		m_pEffectVehicle->SetNormalMap(m_pNormalTexture); 
+		m_pEffectVehicle->SetNormalRotations(pMesh->GetNormalRotationView());
+
+		//Fire OBJ
+		std::vector<Vertex_PosCol> vertices{};
+		std::vector<uint32_t> indices{};
+		const std::string fileNameFire{ m_FireMeshPath };
+
+		Utils::ParseOBJ(fileNameFire, vertices, indices);
+		OptimizeMeshIndices(fileNameFire, vertices, indices);
+		assert(indices.size() / 3 <= m_MaxVisibilityTriangles);
+		pMesh = m_pMeshObjects.emplace_back(new Mesh{ m_pDevice, vertices, indices, m_pEffectFire, false, Residency::gpuOnly });
+		m_pEffectFire->SetDiffuseMap(m_pFireTexture);
+
+		//the software path packs the mesh index and triangle index of a pixel into one visibility id
+		assert(m_pMeshObjects.size() <= m_MaxVisibilityMeshes);
+
+		//Togglinng Info
+		PrintingInfo(); 
+		PrintMemoryReport();
+	}
+
+	Renderer::~Renderer()
+	{
+		delete m_pCamera;
+		
+		for (auto mesh : m_pMeshObjects)
+		{
+			delete mesh;
+			mesh = nullptr;
+		}
+
+		delete m_pEffectVehicle;
+		delete m_pDiffuseTexture;
+		delete m_pSpecularTexture;
+		delete m_pGlossinessTexture;
+		delete m_pNormalTexture;
+		delete m_pVehicleMaterial;
+		delete m_pFireTexture;
+		delete m_pEffectFire;
+		delete[] m_pColourBufferPixels;
+		delete[] m_pDepthBufferPixels;
+		delete[] m_pVisibilityBufferPixels;
+		delete m_pSpecularPower;
+		delete m_pFrameArena;
+
+		m_pRenderTargetView->Release(); 
+		m_pRenderTargetBuffer->Release(); 
+		m_pDepthStencilView->Release(); 
+		m_pDepthStencilBuffer->Release(); 
+		m_pSwapChain->Release(); 
+
+		if (m_pDeviceContext) 
+		{
+			m_pDeviceContext->ClearState(); 
+			m_pDeviceContext->Flush(); 
+			m_pDeviceContext->Release(); 
+		}
+
+		m_pDevice->Release();  
+
+		m_pEffectFire = nullptr;
+		m_pEffectVehicle = nullptr;
+		m_pCamera = nullptr;
+		m_pDiffuseTexture = nullptr;
+		m_pSpecularTexture = nullptr;
+		m_pGlossinessTexture = nullptr;
+		m_pNormalTexture = nullptr;
+		m_pVehicleMaterial = nullptr;
+		m_pFireTexture = nullptr;
+	}
+
+	void Renderer::Update(const Timer* pTimer)
+	{
+		const AllocationTracker::Scope allocationScope{ Subsystem::renderer };
+
+		m_pCamera->Update(pTimer); 
+		
+		//Variables
+		const float yaw{ (pTimer->GetElapsed() * 45.f) * TO_RADIANS }; 
+		const Matrix rotation{ Matrix::CreateRotationY(yaw) };
+
+		//Check if it needs to be rotating
+		if (m_IsRotating)
+		{
+			//Rotate Mesh
+			for (auto mesh : m_pMeshObjects)
+			{
+				mesh->RotateMesh(yaw);
+			}
+		}
+
+		//Set Camera Position
+		for (auto mesh : m_pMeshObjects)
+		{
+			mesh->SetCameraPosition(m_pCamera->GetCameraOrigin());
+		}
+	}
+
+	void Renderer::Render() const
+	{
+		const AllocationTracker::Scope allocationScope{ Subsystem::renderer };
+
+		if (!m_IsInitialized)
+			return;
+
+		if (m_RasterizerSettings == RasterizerSettings::hardware)
+		{
+			Render_Hardware();
+		}
+
+		if (m_RasterizerSettings == RasterizerSettings::software)
+		{
+			//@START
+			//Lock BackBuffer
+			SDL_LockSurface(m_pBackBuffer);
+			
+			Render_Software();
+
+			//@END
+			//Update SDL Surface
+			SDL_UnlockSurface(m_pBackBuffer);
+			SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0); 
+			SDL_UpdateWindowSurface(m_pWindow); 
+		}
+	}
+
+	// -----------------------------
+	//		  HARDWARE PART
+	// -----------------------------
+	void Renderer::Render_Hardware() const
+	{
+		//1. CLEAR RTV & DSV
+		constexpr float backgroundColor[4] = { 0.39f, 0.59f, 0.93f, 1.f };
+		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, backgroundColor);
+		m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
+
+		//2. SET PIPELINE + INVOKE DRAW CALLS (= RENDER)
+		const Matrix inverseViewMatrix = m_pCamera->GetInverseViewMatrix(); 
+		const Matrix projectionMatrix = m_pCamera->GetProjectionMatrix();
+
+		//first make view projection matrix
+		const Matrix worldViewProjectionMatrix{ m_pMeshObjects[0]->GetWorldMatrix() * inverseViewMatrix * projectionMatrix };
+		//Render Vehicle Mesh
+		m_pMeshObjects[0]->Render(m_pDeviceContext, worldViewProjectionMatrix); 
+
+		//Check if Fire Mesh needs to be visible
+		if (m_IsShowingFireMesh)
+		{
+			//first make view projection matrix
+			const Matrix worldViewProjectionMatrix{ m_pMeshObjects[1]->GetWorldMatrix() * inverseViewMatrix * projectionMatrix }; 
+			//Render Fire Mesh
+			m_pMeshObjects[1]->Render(m_pDeviceContext, worldViewProjectionMatrix); 
+		}
+
+		//3. PRESENT BACKBUFFER (SWAP)
+		m_pSwapChain->Present(0, 0);
+	}
+
+	HRESULT Renderer::InitializeDirectX()
+	{
+		//1. Create Device & Device Context
+		//=====
+		D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_1;
+		uint32_t createDeviceFlags = 0;
+#if defined(DEBUG) || defined(_DEBUG)
+		// |=  -->  bitwise OR operator combined with assignment
+		//createDeviceFlags = createDeviceFlags | D3D11_CREATE_DEVICE_DEBUG;
+		createDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+		HRESULT result = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, 0, createDeviceFlags, &featureLevel, 1, D3D11_SDK_VERSION,
+			&m_pDevice, nullptr, &m_pDeviceContext);
+		if (FAILED(result))
+		{
+			return result;
+		}
+
+		//Create DXGI Factory
+		IDXGIFactory1* pDxgiFactory{};
+		//void** --> represents pointer to location that stored another pointer to void
+		result = CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**>(&pDxgiFactory));
+		if (FAILED(result))
+		{
+			return result;
+		}
+
+		//2. Create Swapchain
+		//=====
+		DXGI_SWAP_CHAIN_DESC swapChainDesc{};
+		swapChainDesc.BufferDesc.Width = m_Width;
+		swapChainDesc.BufferDesc.Height = m_Height;
+		swapChainDesc.BufferDesc.RefreshRate.Numerator = 1;
+		swapChainDesc.BufferDesc.RefreshRate.Denominator = 60;
+		swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+		swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+		swapChainDesc.SampleDesc.Count = 1;
+		swapChainDesc.SampleDesc.Quality = 0;
+		swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+		swapChainDesc.BufferCount = 1;
+		swapChainDesc.Windowed = true;
+		swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+		swapChainDesc.Flags = 0;
+
+		//Get the handle (HWND) from the SDL backbuffer
+		SDL_SysWMinfo sysWMInfo{};
+		SDL_GetVersion(&sysWMInfo.version);
+		SDL_GetWindowWMInfo(m_pWindow, &sysWMInfo);
+		swapChainDesc.OutputWindow = sysWMInfo.info.win.window;
+
+		//Create SwapChain
+		result = pDxgiFactory->CreateSwapChain(m_pDevice, &swapChainDesc, &m_pSwapChain);
+		if (FAILED(result))
+		{
+			return result;
+		}
+
+		//3. Create DepthStencil (DS) and DepthStencilView (DSV)
+		//=====
+		D3D11_TEXTURE2D_DESC depthStencilDesc{};
+		depthStencilDesc.Width = m_Width;
+		depthStencilDesc.Height = m_Height;
+		depthStencilDesc.MipLevels = 1;
+		depthStencilDesc.ArraySize = 1;
+		depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+		depthStencilDesc.SampleDesc.Count = 1;
+		depthStencilDesc.SampleDesc.Quality = 0;
+		depthStencilDesc.Usage = D3D11_USAGE_DEFAULT;
+		depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+		depthStencilDesc.CPUAccessFlags = 0;
+		depthStencilDesc.MiscFlags = 0;
+
+		//View
+		D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
+		depthStencilViewDesc.Format = depthStencilDesc.Format;
+		depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+		depthStencilViewDesc.Texture2D.MipSlice = 0;
+
+		result = m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer);
+		if (FAILED(result))
+		{
+			return result;
+		}
+
+		result = m_pDevice->CreateDepthStencilView(m_pDepthStencilBuffer, &depthStencilViewDesc, &m_pDepthStencilView);
+		if (FAILED(result))
+		{
+			return result;
+		}
+
+		//4. Create RenderTarget (RT) & RenderTargetView (RTV)
+		//=====
+
+		//Resource
+		result = m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&m_pRenderTargetBuffer));
+		if (FAILED(result))
+		{
+			return result;
+		}
+
+		//View
+		result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer, nullptr, &m_pRenderTargetView);
+		if (FAILED(result))
+		{
+			return result;
+		}
+
+		//5. Bind RTV & DSV to Output Merger Stage
+		//=====
+		m_pDeviceContext->OMSetRenderTargets(1, &m_pRenderTargetView, m_pDepthStencilView);
+
+		//6. Set Viewport
+		//=====
+		D3D11_VIEWPORT viewport{};
+		viewport.Width = static_cast<float>(m_Width);
+		viewport.Height = static_cast<float>(m_Height);
+		viewport.TopLeftX = 0.f;
+		viewport.TopLeftY = 0.f;
+		viewport.MinDepth = 0.f;
+		viewport.MaxDepth = 1.f;
+		m_pDeviceContext->RSSetViewports(1, &viewport);
+
+		return result;
+
+		//hidden resource leak of DXGI factory
+		pDxgiFactory->Release();
+	}
+
+	// -----------------------------
+	//		  TOGGLING PART
+	// -----------------------------
+
+	// Not const because otherwise i cannnot change the SamplerState
+	void Renderer::ToggleSamplerState()
+	{
+		//the software sampler mirrors the hardware one, so both always cycle together
+		for (auto mesh : m_pMeshObjects)
+		{
+			mesh->ToggleSamplerState();
+		}
+
+		//Sampler State to check what I need to print out
+		switch (m_Samples)
+		{
+		case SamplerStates::point:
+			m_Samples = SamplerStates::linear;
+			std::cout << "Sampling Filter: D3D11_FILTER_MIN_MAG_MIP_LINEAR" << std::endl;
+			break;
+
+		case SamplerStates::linear:
+			m_Samples = SamplerStates::anisotropic;
+			std::cout << "Sampling Filter: D3D11_FILTER_MIN_MAG_MIP_ANISOTROPIC" << std::endl;
+			break;
+
+		case SamplerStates::anisotropic:
+			m_Samples = SamplerStates::point;
+			std::cout << "Sampling Filter: D3D11_FILTER_MIN_MAG_MIP_POINT" << std::endl;
+			break;
+		}
+	}
+
+	void Renderer::ToggleShadingModes()
+	{
+		if (m_RasterizerSettings == RasterizerSettings::software)
+		{
+			const int amountOfShadingModes{ 4 }; 
+
+			int temp{ static_cast<int>(m_ShadingMode) }; 
+			m_ShadingMode = static_cast<ShadingModes>((++temp) % amountOfShadingModes); 
+
+			switch (m_ShadingMode)
+			{
+			case dae::Renderer::ShadingModes::cosineLambert:
+				std::cout << "Render Mode: Cosine Lambert Mode" << std::endl;
+				break;
+			case dae::Renderer::ShadingModes::diffuseLambert:
+				std::cout << "Render Mode: Diffuse Lambert Mode" << std::endl;
+				break;
+			case dae::Renderer::ShadingModes::specularPhong:
+				std::cout << "Render Mode: Specular Phong Mode" << std::endl;
+				break;
+			case dae::Renderer::ShadingModes::combined:
+				std::cout << "Render Mode: Combined Mode" << std::endl;
+				break;
+			}
+		}
+	}
+
+	void Renderer::ToggleRotation()
+	{
+		m_IsRotating = !m_IsRotating;
+	}
+
+	void Renderer::ToggleNormalMap()
+	{
+		for (auto mesh : m_pMeshObjects)
+		{
+			mesh->ToggleNormalMap(); 
+		}
+
+		m_IsNormalMapOn = !m_IsNormalMapOn;
+
+		if (m_IsNormalMapOn)
+		{
+			std::cout << "Sample normal map: ON\n";
+		}
+		else
+		{
+			std::cout << "Sample normal map: OFF\n";
+		}
+	}
+
+	void Renderer::ToggleFireMesh()
+	{
+		if (m_RasterizerSettings == RasterizerSettings::hardware)
+		{
+			m_IsShowingFireMesh = !m_IsShowingFireMesh;
+		}
+	}
+
+	void Renderer::ToggleRenderingSettings()
+	{
+		switch (m_RasterizerSettings)
+		{
+		case Renderer::RasterizerSettings::software:
+			m_RasterizerSettings = RasterizerSettings::hardware;
+			std::cout << "Render setting: Hardware" << std::endl;
+			break;
+		case Renderer::RasterizerSettings::hardware:
+			MakeSoftwareResident();
+			m_RasterizerSettings = RasterizerSettings::software;
+			std::cout << "Render setting: Software" << std::endl;
+			break;
+		default:
+
+			break;
+		}
+	}
+
+	void Renderer::ToggleRenderModes()
+	{
+		if (m_RasterizerSettings == RasterizerSettings::software)
+		{
+			const int amountOfRenderModes{ 3 }; 
+
+			int temp{ static_cast<int>(m_RenderMode) }; 
+			m_RenderMode = static_cast<RenderMode>((++temp) % amountOfRenderModes); 
+		}
+	}
+
+	void Renderer::ToggleRasterizerKernel()
+	{
+		if (m_RasterizerSettings == RasterizerSettings::software)
+		{
+			//from the fastest kernel the CPU runs down to the scalar reference and back
+			m_RasterizerKernel = m_RasterizerKernel == RasterizerKernel::scalar ? m_FastestRasterizerKernel : static_cast<RasterizerKernel>(static_cast<int>(m_RasterizerKernel) + 1);
+
+			switch (m_RasterizerKernel)
+			{
+			case RasterizerKernel::avx512:
+				std::cout << "Rasterizer Kernel: AVX-512 (16-wide rasterizing and vertex transform, 8-wide shading)" << std::endl;
+				break;
+			case RasterizerKernel::avx2:
+				std::cout << "Rasterizer Kernel: AVX2 (rasterizing and 8-wide shading)" << std::endl;
+				break;
+			case RasterizerKernel::scalar:
+				std::cout << "Rasterizer Kernel: Scalar (reference rasterizing and shading)" << std::endl;
+				break;
+			}
+
+			//rasterize again so the new kernel is what ends up in the visibility buffer
+			m_IsVisibilityBufferValid = false;
+		}
+	}
+
+	void Renderer::ToggleSpecularPower()
+	{
+		if (m_RasterizerSettings == RasterizerSettings::software)
+		{
+			const int amountOfSpecularPowerModes{ 3 };
+
+			int temp{ static_cast<int>(m_SpecularPowerMode) };
+			m_SpecularPowerMode = static_cast<SpecularPowerMode>((++temp) % amountOfSpecularPowerModes);
+
+			switch (m_SpecularPowerMode)
+			{
+			case SpecularPowerMode::powf:
+				std::cout << "Specular Power: std::powf (reference)" << std::endl;
+				break;
+			case SpecularPowerMode::lookupTable:
+				std::cout << "Specular Power: Lookup Table" << std::endl;
+				break;
+			case SpecularPowerMode::polynomial:
+				std::cout << "Specular Power: Polynomial exp2 and log2" << std::endl;
+				break;
+			}
+		}
+	}
+
+	void Renderer::ToggleCullModes()
+	{
+		if (m_RasterizerSettings == RasterizerSettings::software)
+		{
+			const int amountOfCullModes{ 3 };
+
+			int temp{ static_cast<int>(m_CullMode) };
+			m_CullMode = static_cast<CullModes>((++temp) % amountOfCullModes);
+
+			switch (m_CullMode)
+			{
+			case CullModes::back:
+				std::cout << "Cull Mode: Back" << std::endl;
+				break;
+			case CullModes::front:
+				std::cout << "Cull Mode: Front" << std::endl;
+				break;
+			case CullModes::none:
+				std::cout << "Cull Mode: None" << std::endl;
+				break;
+			}
+
+			//different triangles end up in the visibility buffer
+			m_IsVisibilityBufferValid = false;
+		}
+	}
+
+	void Renderer::ToggleShadingPipeline()
+	{
+		if (m_RasterizerSettings == RasterizerSettings::software)
+		{
+			switch (m_ShadingPipeline)
+			{
+			case ShadingPipeline::forward:
+				m_ShadingPipeline = ShadingPipeline::visibilityBuffer;
+				std::cout << "Shading Pipeline: Visibility Buffer" << std::endl;
+				break;
+			case ShadingPipeline::visibilityBuffer:
+				m_ShadingPipeline = ShadingPipeline::forward;
+				std::cout << "Shading Pipeline: Forward" << std::endl;
+				break;
+			}
+		}
+	}
+
+	// -----------------------------
+	//		  SOFTWARE PART
+	// -----------------------------
+	void Renderer::MakeSoftwareResident()
+	{
+		const AllocationTracker::Scope allocationScope{ Subsystem::renderer };
+
+		//Only the first switch pays for this, the CPU copies stay once the software path has used them
+		if (m_pVehicleMaterial != nullptr)
+		{
+			return;
+		}
+
+		//The vehicle maps are only read to interleave them, the material is the copy the software shader samples
+		for (Texture* pTexture : { m_pDiffuseTexture, m_pSpecularTexture, m_pGlossinessTexture, m_pNormalTexture })
+		{
+			pTexture->SetCpuResident(true);
+		}
+
+		m_pVehicleMaterial = new MaterialTexture{ m_pDiffuseTexture, m_pSpecularTexture, m_pGlossinessTexture, m_pNormalTexture };
+		m_pSpecularPower->PrintAccuracyReport(m_pGlossinessTexture);
+
+		for (Texture* pTexture : { m_pDiffuseTexture, m_pSpecularTexture, m_pGlossinessTexture, m_pNormalTexture })
+		{
+			pTexture->SetCpuResident(false);
+		}
+
+		//Parsing and optimizing again gives the same vertices and indices that were uploaded. The constructor's copies are not kept
+		//for this on purpose: a session that stays on the GPU never holds the vertices, indices and rotations on the CPU, and one that
+		//switches pays for the parse, the optimization and the rotations once
+		Mesh* pVehicleMesh{ m_pMeshObjects[0] };
+		if (pVehicleMesh->GetResidency() == Residency::gpuOnly)
+		{
+			std::vector<Vertex_PosCol> vertices{};
+			std::vector<uint32_t> indices{};
+
+			LoadVehicleGeometry(vertices, indices);
+			pVehicleMesh->SetNormalRotations(NormalMapBaker::ComputeNormalRotations(vertices, indices, m_pNormalTexture->GetWidth(), m_pNormalTexture->GetHeight()));
+			pVehicleMesh->SetCpuData(std::move(vertices), std::move(indices));
+		}
+
+		PrintMemoryReport();
+	}
+
+	void Renderer::Render_Software() const
+	{
+		const uint32_t clearColour{ PackColour(100, 100, 100) };
+		const Subsystem subsystem{ AllocationTracker::GetCurrentSubsystem() };
+
+		if (m_ShadingPipeline == ShadingPipeline::visibilityBuffer)
+		{
+			//Nothing moved since the last rasterization, only the shading pass has to run again
+			if (IsVisibilityBufferCurrent())
+			{
+				std::for_each(std::execution::par, m_Tiles.begin(), m_Tiles.end(), [&](Tile& tile)
+					{
+						const AllocationTracker::Scope allocationScope{ subsystem };
+						ShadeVisibilityTile(tile, clearColour);
+						ResolveTile(tile);
+					});
+
+				return;
+			}
+
+			//Computed like IsVisibilityBufferCurrent does, and only reallocated when the amount of meshes changes
+			const Matrix viewProjectionMatrix{ m_pCamera->GetViewMatrix() * m_pCamera->GetProjectionMatrix() };
+			m_VisibilityWorldViewProjections.resize(m_pMeshObjects.size());
+			for (size_t meshIdx{ 0 }; meshIdx < m_pMeshObjects.size(); ++meshIdx)
+			{
+				m_VisibilityWorldViewProjections[meshIdx] = m_pMeshObjects[meshIdx]->GetWorldMatrix() * viewProjectionMatrix;
+			}
+		}
+
+		//Everything the last rasterized frame left in the arena is rebuilt below
+		m_pFrameArena->Reset();
+
+		//From World to View to Projection to Screen space
+		VertexTransformationFunction(m_pMeshObjects);
+
+		//Sort the transformed triangles in the screen tiles they overlap
+		BinTriangles();
+
+		//Every tile is rasterized by its own worker, tiles never share pixels so no locking is needed
+		std::for_each(std::execution::par, m_Tiles.begin(), m_Tiles.end(), [&](Tile& tile)
+			{
+				const AllocationTracker::Scope allocationScope{ subsystem };
+				RenderTile(tile, clearColour);
+
+				if (m_ShadingPipeline == ShadingPipeline::visibilityBuffer)
+				{
+					ShadeVisibilityTile(tile, clearColour);
+				}
+
+				ResolveTile(tile);
+			});
+
+		m_IsVisibilityBufferValid = m_ShadingPipeline == ShadingPipeline::visibilityBuffer;
+	}
+
+	void Renderer::VertexTransformationFunction(const std::vector<Mesh*>& meshes_in) const
+	{
+		const Matrix viewProjectionMatrix{ m_pCamera->GetViewMatrix() * m_pCamera->GetProjectionMatrix() };
+		const Subsystem subsystem{ AllocationTracker::GetCurrentSubsystem() };
+
+		for (Mesh* pMesh : meshes_in)
+		{
+			//Meshes the software path does not draw have no CPU copy to transform
+			if (!pMesh->GetIsInSoftwareMode())
+			{
+				continue;
+			}
+
+			const Matrix worldMatrix{ pMesh->GetWorldMatrix() };
+			const Matrix worldViewProjectionMatrix{ worldMatrix * viewProjectionMatrix };
+
+			const VertexStreams& streams{ pMesh->GetVertexStreams() };
+			const std::span<Vertex_Out> meshVerticesOut{ m_pFrameArena->Allocate<Vertex_Out>(streams.amountOfVertices) };
+
+			//every chunk writes its own range of the output, the workers never share a vertex
+			const std::span<size_t> chunkBegins{ m_pFrameArena->Allocate<size_t>((streams.amountOfVertices + m_VertexChunkSize - 1) / m_VertexChunkSize) };
+			for (size_t chunkIdx{ 0 }; chunkIdx < chunkBegins.size(); ++chunkIdx)
+			{
+				chunkBegins[chunkIdx] = chunkIdx * m_VertexChunkSize;
+			}
+
+			std::for_each(std::execution::par, chunkBegins.begin(), chunkBegins.end(), [&](size_t begin)
+				{
+					const AllocationTracker::Scope allocationScope{ subsystem };
+					const size_t end{ std::min(begin + m_VertexChunkSize, streams.amountOfVertices) };
+
+					switch (m_RasterizerKernel)
+					{
+					case RasterizerKernel::avx512:
+						TransformVerticesAVX512(streams, begin, end, worldMatrix, worldViewProjectionMatrix, meshVerticesOut.data());
+						break;
+					case RasterizerKernel::avx2:
+						TransformVerticesAVX2(streams, begin, end, worldMatrix, worldViewProjectionMatrix, meshVerticesOut.data());
+						break;
+					case RasterizerKernel::scalar:
+						TransformVertices(streams, begin, end, worldMatrix, worldViewProjectionMatrix, meshVerticesOut.data());
+						break;
+					}
+				});
+
+			pMesh->SetMeshVerticesOut(meshVerticesOut);
+
+			//per triangle, the rotation out of the frame its normal map texels were baked in followed by the world matrix
+			const std::span<const Matrix> normalRotations{ pMesh->GetNormalRotations() };
+			const std::span<Matrix> normalMatricesOut{ m_pFrameArena->Allocate<Matrix>(normalRotations.size()) };
+
+			for (size_t triangleIdx{ 0 }; triangleIdx < normalMatricesOut.size(); ++triangleIdx)
+			{
+				const Matrix& rotation{ normalRotations[triangleIdx] };
+				Matrix& normalMatrix{ normalMatricesOut[triangleIdx] };
+
+				//only the 3x3 parts are used, the last row is only there so no row is left unwritten
+				for (int row{ 0 }; row < 3; ++row)
+				{
+					const Vector4 rotationRow{ rotation[row] };
+					normalMatrix[row] = Vector4{ worldMatrix.TransformVector(rotationRow.x, rotationRow.y, rotationRow.z), 0.f };
+				}
+				normalMatrix[3] = Vector4{ 0.f, 0.f, 0.f, 1.f };
+			}
+
+			pMesh->SetNormalMatricesOut(normalMatricesOut);
+		}
+	}
+
+	void Renderer::TransformVertices(const VertexStreams& streams, size_t begin, size_t end, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, Vertex_Out* pVerticesOut) const
+	{
+		const Vector3 cameraOrigin{ m_pCamera->GetCameraOrigin() };
+
+		for (size_t idx{ begin }; idx < end; ++idx)
+		{
+			const Vector3 position{ streams.position[0][idx], streams.position[1][idx], streams.position[2][idx] };
+			const Vector3 normal{ streams.normal[0][idx], streams.normal[1][idx], streams.normal[2][idx] };
+
+			//stays in clip space, the perspective divide happens after clipping
+			Vertex_Out& vertexOut{ pVerticesOut[idx] };
+			vertexOut.position = worldViewProjectionMatrix.TransformPoint(Vector4{ position, 1.f });
+			vertexOut.color = ColorRGB{ streams.color[0][idx], streams.color[1][idx], streams.color[2][idx] };
+			vertexOut.uv = Vector2{ streams.uv[0][idx], streams.uv[1][idx] };
+			vertexOut.normal = worldMatrix.TransformVector(normal).Normalized();
+			vertexOut.viewDirection = worldMatrix.TransformVector(position) - cameraOrigin;
+		}
+	}
+
+	void Renderer::TransformVerticesAVX2(const VertexStreams& streams, size_t begin, size_t end, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, Vertex_Out* pVerticesOut) const
+	{
+		const Vector3 cameraOrigin{ m_pCamera->GetCameraOrigin() };
+
+		//every matrix element in all lanes, the matrices take row vectors so a column makes one output component
+		__m256 worldViewProjection[4][4]{};
+		__m256 world[3][3]{};
+
+		for (int row{ 0 }; row < 4; ++row)
+		{
+			for (int column{ 0 }; column < 4; ++column)
+			{
+				worldViewProjection[row][column] = _mm256_set1_ps(worldViewProjectionMatrix[row][column]);
+
+				if (row < 3 && column < 3)
+				{
+					world[row][column] = _mm256_set1_ps(worldMatrix[row][column]);
+				}
+			}
+		}
+
+		constexpr size_t amountOfLanes{ 8 };
+
+		//the streams are padded, the last group of a mesh reads past its end but only writes the vertices that exist
+		for (size_t groupIdx{ begin }; groupIdx < end; groupIdx += amountOfLanes)
+		{
+			const __m256 position[3]{ _mm256_loadu_ps(&streams.position[0][groupIdx]), _mm256_loadu_ps(&streams.position[1][groupIdx]), _mm256_loadu_ps(&streams.position[2][groupIdx]) };
+			const __m256 normal[3]{ _mm256_loadu_ps(&streams.normal[0][groupIdx]), _mm256_loadu_ps(&streams.normal[1][groupIdx]), _mm256_loadu_ps(&streams.normal[2][groupIdx]) };
+
+			float clipPosition[4][m_ShadingLanes]{};
+			float worldNormal[3][m_ShadingLanes]{};
+			float viewDirection[3][m_ShadingLanes]{};
+
+			for (int column{ 0 }; column < 4; ++column)
+			{
+				__m256 value{ _mm256_fmadd_ps(position[2], worldViewProjection[2][column], worldViewProjection[3][column]) };
+				value = _mm256_fmadd_ps(position[1], worldViewProjection[1][column], value);
+				value = _mm256_fmadd_ps(position[0], worldViewProjection[0][column], value);
+				_mm256_storeu_ps(clipPosition[column], value);
+			}
+
+			__m256 transformedNormal[3]{};
+			for (int column{ 0 }; column < 3; ++column)
+			{
+				transformedNormal[column] = _mm256_fmadd_ps(normal[2], world[2][column], _mm256_fmadd_ps(normal[1], world[1][column], _mm256_mul_ps(normal[0], world[0][column])));
+
+				const __m256 worldPosition{ _mm256_fmadd_ps(position[2], world[2][column], _mm256_fmadd_ps(position[1], world[1][column], _mm256_mul_ps(position[0], world[0][column]))) };
+				_mm256_storeu_ps(viewDirection[column], _mm256_sub_ps(worldPosition, _mm256_set1_ps(cameraOrigin[column])));
+			}
+
+			//a true divide by the length like Vector3::Normalized, the normal is interpolated and normalized again per pixel anyway
+			const __m256 length{ _mm256_sqrt_ps(_mm256_fmadd_ps(transformedNormal[2], transformedNormal[2],
+				_mm256_fmadd_ps(transformedNormal[1], transformedNormal[1], _mm256_mul_ps(transformedNormal[0], transformedNormal[0])))) };
+
+			for (int component{ 0 }; component < 3; ++component)
+			{
+				_mm256_storeu_ps(worldNormal[component], _mm256_div_ps(transformedNormal[component], length));
+			}
+
+			const int amountOfVertices{ static_cast<int>(std::min(end - groupIdx, amountOfLanes)) };
+			for (int lane{ 0 }; lane < amountOfVertices; ++lane)
+			{
+				const size_t idx{ groupIdx + lane };
+
+				Vertex_Out& vertexOut{ pVerticesOut[idx] };
+				vertexOut.position = Vector4{ clipPosition[0][lane], clipPosition[1][lane], clipPosition[2][lane], clipPosition[3][lane] };
+				vertexOut.color = ColorRGB{ streams.color[0][idx], streams.color[1][idx], streams.color[2][idx] };
+				vertexOut.uv = Vector2{ streams.uv[0][idx], streams.uv[1][idx] };
+				vertexOut.normal = Vector3{ worldNormal[0][lane], worldNormal[1][lane], worldNormal[2][lane] };
+				vertexOut.viewDirection = Vector3{ viewDirection[0][lane], viewDirection[1][lane], viewDirection[2][lane] };
+			}
+		}
+	}
+
+	void Renderer::TransformVerticesAVX512(const VertexStreams& streams, size_t begin, size_t end, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, Vertex_Out* pVerticesOut) const
+	{
+		const Vector3 cameraOrigin{ m_pCamera->GetCameraOrigin() };
+
+		//the AVX2 transform on 16 lanes, the operations and their order are the same so both give the same vertices
+		__m512 worldViewProjection[4][4]{};
+		__m512 world[3][3]{};
+
+		for (int row{ 0 }; row < 4; ++row)
+		{
+			for (int column{ 0 }; column < 4; ++column)
+			{
+				worldViewProjection[row][column] = _mm512_set1_ps(worldViewProjectionMatrix[row][column]);
+
+				if (row < 3 && column < 3)
+				{
+					world[row][column] = _mm512_set1_ps(worldMatrix[row][column]);
+				}
+			}
+		}
+
+		constexpr size_t amountOfLanes{ 16 };
+
+		for (size_t groupIdx{ begin }; groupIdx < end; groupIdx += amountOfLanes)
+		{
+			const __m512 position[3]{ _mm512_loadu_ps(&streams.position[0][groupIdx]), _mm512_loadu_ps(&streams.position[1][groupIdx]), _mm512_loadu_ps(&streams.position[2][groupIdx]) };
+			const __m512 normal[3]{ _mm512_loadu_ps(&streams.normal[0][groupIdx]), _mm512_loadu_ps(&streams.normal[1][groupIdx]), _mm512_loadu_ps(&streams.normal[2][groupIdx]) };
+
+			float clipPosition[4][amountOfLanes]{};
+			float worldNormal[3][amountOfLanes]{};
+			float viewDirection[3][amountOfLanes]{};
+
+			for (int column{ 0 }; column < 4; ++column)
+			{
+				__m512 value{ _mm512_fmadd_ps(position[2], worldViewProjection[2][column], worldViewProjection[3][column]) };
+				value = _mm512_fmadd_ps(position[1], worldViewProjection[1][column], value);
+				value = _mm512_fmadd_ps(position[0], worldViewProjection[0][column], value);
+				_mm512_storeu_ps(clipPosition[column], value);
+			}
+
+			__m512 transformedNormal[3]{};
+			for (int column{ 0 }; column < 3; ++column)
+			{
+				transformedNormal[column] = _mm512_fmadd_ps(normal[2], world[2][column], _mm512_fmadd_ps(normal[1], world[1][column], _mm512_mul_ps(normal[0], world[0][column])));
+
+				const __m512 worldPosition{ _mm512_fmadd_ps(position[2], world[2][column], _mm512_fmadd_ps(position[1], world[1][column], _mm512_mul_ps(position[0], world[0][column]))) };
+				_mm512_storeu_ps(viewDirection[column], _mm512_sub_ps(worldPosition, _mm512_set1_ps(cameraOrigin[column])));
+			}
+
+			const __m512 length{ _mm512_sqrt_ps(_mm512_fmadd_ps(transformedNormal[2], transformedNormal[2],
+				_mm512_fmadd_ps(transformedNormal[1], transformedNormal[1], _mm512_mul_ps(transformedNormal[0], transformedNormal[0])))) };
+
+			for (int component{ 0 }; component < 3; ++component)
+			{
+				_mm512_storeu_ps(worldNormal[component], _mm512_div_ps(transformedNormal[component], length));
+			}
+
+			const int amountOfVertices{ static_cast<int>(std::min(end - groupIdx, amountOfLanes)) };
+			for (int lane{ 0 }; lane < amountOfVertices; ++lane)
+			{
+				const size_t idx{ groupIdx + lane };
+
+				Vertex_Out& vertexOut{ pVerticesOut[idx] };
+				vertexOut.position = Vector4{ clipPosition[0][lane], clipPosition[1][lane], clipPosition[2][lane], clipPosition[3][lane] };
+				vertexOut.color = ColorRGB{ streams.color[0][idx], streams.color[1][idx], streams.color[2][idx] };
+				vertexOut.uv = Vector2{ streams.uv[0][idx], streams.uv[1][idx] };
+				vertexOut.normal = Vector3{ worldNormal[0][lane], worldNormal[1][lane], worldNormal[2][lane] };
+				vertexOut.viewDirection = Vector3{ viewDirection[0][lane], viewDirection[1][lane], viewDirection[2][lane] };
+			}
+		}
+	}
+
+	void Renderer::BinTriangles() const
+	{
+		m_TriangleStats = TriangleStats{};
+
+		const auto isBinned = [](const Mesh* pMesh)
+			{
+				return pMesh->GetIsInSoftwareMode() && pMesh->GetPrimitiveTopology() == PrimitiveTopology::TriangleList;
+			};
+
+		//room for one setup per triangle, only triangles clipped into fans can make the array grow
+		size_t amountOfTriangles{};
+		for (const Mesh* pMesh : m_pMeshObjects)
+		{
+			amountOfTriangles += isBinned(pMesh) ? pMesh->GetMeshIndices().size() / 3 : 0;
+		}
+
+		std::span<TriangleSetupRecord> setups{ m_pFrameArena->Allocate<TriangleSetupRecord>(amountOfTriangles) };
+		size_t amountOfSetups{};
+
+		for (uint32_t meshIdx{ 0 }; meshIdx < m_pMeshObjects.size(); ++meshIdx)
+		{
+			Mesh* pMesh{ m_pMeshObjects[meshIdx] };
+
+			// Check if Mesh needs to be loaded in Software mode
+			if (!isBinned(pMesh))
+			{
+				continue;
+			}
+
+			const auto meshIndices = pMesh->GetMeshIndices();
+			const auto meshVerticesOut = pMesh->GetMeshVerticesOut();
+
+			// Assuming GetMeshIndices() always contains a multiple of 3 indices
+			for (size_t triangleIdx = 0; triangleIdx < meshIndices.size(); triangleIdx += 3)
+			{
+				const Vertex_Out& v0 = meshVerticesOut[meshIndices[triangleIdx + 0]];
+				const Vertex_Out& v1 = meshVerticesOut[meshIndices[triangleIdx + 1]];
+				const Vertex_Out& v2 = meshVerticesOut[meshIndices[triangleIdx + 2]];
+
+				//a clipped triangle comes back as a convex polygon, drawn as a fan
+				Vertex_Out clippedVertices[m_MaxClippedVertices]{};
+				const int amountOfClippedVertices{ ClipTriangle(v0, v1, v2, clippedVertices) };
+
+				for (int fanIdx{ 1 }; fanIdx + 1 < amountOfClippedVertices; ++fanIdx)
+				{
+					TriangleSetupRecord setup{};
+					if (!TriangleSetup(clippedVertices[0], clippedVertices[fanIdx], clippedVertices[fanIdx + 1], setup))
+					{
+						continue;
+					}
+
+					setup.visibilityId = (meshIdx << m_VisibilityTriangleBits) | static_cast<uint32_t>(triangleIdx / 3);
+
+					//the old array stays behind in the arena until the next reset
+					if (amountOfSetups == setups.size())
+					{
+						const std::span<TriangleSetupRecord> grownSetups{ m_pFrameArena->Allocate<TriangleSetupRecord>(std::max<size_t>(setups.size() * 2, 64)) };
+						std::copy(setups.begin(), setups.end(), grownSetups.begin());
+						AllocationTracker::CountCopy(setups.size_bytes());
+						setups = grownSetups;
+					}
+
+					setups[amountOfSetups++] = setup;
+				}
+			}
+		}
+
+		m_TriangleSetups = setups.first(amountOfSetups);
+
+		//convert the bounding box to a range of tiles
+		const auto forEachOverlappedTile = [this](const TriangleSetupRecord& setup, const auto& tileFunction)
+			{
+				for (int tileY{ setup.minY / m_TileSize }; tileY <= (setup.maxY - 1) / m_TileSize; ++tileY)
+				{
+					for (int tileX{ setup.minX / m_TileSize }; tileX <= (setup.maxX - 1) / m_TileSize; ++tileX)
+					{
+						tileFunction(tileX + (tileY * m_AmountOfTilesX));
+					}
+				}
+			};
+
+		//the bins are counted first, so they can be consecutive slices of one array
+		const std::span<uint32_t> binSizes{ m_pFrameArena->Allocate<uint32_t>(m_Tiles.size()) };
+		std::fill(binSizes.begin(), binSizes.end(), 0u);
+
+		for (const TriangleSetupRecord& setup : m_TriangleSetups)
+		{
+			forEachOverlappedTile(setup, [&](int tileIdx) { ++binSizes[tileIdx]; });
+		}
+
+		uint32_t amountOfBinnedSetups{};
+		for (const uint32_t binSize : binSizes)
+		{
+			amountOfBinnedSetups += binSize;
+		}
+
+		//from here on the counts are turned into where the next index of every bin is written
+		const std::span<uint32_t> binnedSetups{ m_pFrameArena->Allocate<uint32_t>(amountOfBinnedSetups) };
+		uint32_t binBegin{};
+		for (size_t tileIdx{ 0 }; tileIdx < m_Tiles.size(); ++tileIdx)
+		{
+			const uint32_t binSize{ binSizes[tileIdx] };
+			m_Tiles[tileIdx].bin = binnedSetups.subspan(binBegin, binSize);
+			binSizes[tileIdx] = binBegin;
+			binBegin += binSize;
+		}
+
+		//the setups go in in order, every bin stays sorted by submission order
+		for (uint32_t setupIdx{ 0 }; setupIdx < m_TriangleSetups.size(); ++setupIdx)
+		{
+			forEachOverlappedTile(m_TriangleSetups[setupIdx], [&](int tileIdx) { binnedSetups[binSizes[tileIdx]++] = setupIdx; });
+		}
+	}
+
+	int Renderer::ClipTriangle(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, Vertex_Out* pClippedVertices) const
+	{
+		//planes as dot(plane, position) >= 0 on the inside
+		const Vector4 frustumPlanes[]{
+			{ 0.f, 0.f, 1.f, 0.f },		//near
+			{ 0.f, 0.f, -1.f, 1.f },	//far
+			{ 1.f, 0.f, 0.f, 1.f },		//left
+			{ -1.f, 0.f, 0.f, 1.f },	//right
+			{ 0.f, 1.f, 0.f, 1.f },		//bottom
+			{ 0.f, -1.f, 0.f, 1.f } };	//top
+
+		//only the near plane is a real clip, the guard band planes are only hit by triangles too big for the fixed point rasterizer
+		const Vector4 clipPlanes[]{
+			{ 0.f, 0.f, 1.f, 0.f },
+			{ 1.f, 0.f, 0.f, m_GuardBandX },
+			{ -1.f, 0.f, 0.f, m_GuardBandX },
+			{ 0.f, 1.f, 0.f, m_GuardBandY },
+			{ 0.f, -1.f, 0.f, m_GuardBandY } };
+
+		//fully outside one of the frustum planes
+		for (const Vector4& plane : frustumPlanes)
+		{
+			if (Vector4::Dot(plane, v0.position) < 0.f && Vector4::Dot(plane, v1.position) < 0.f && Vector4::Dot(plane, v2.position) < 0.f)
+			{
+				++m_TriangleStats.culled;
+				return 0;
+			}
+		}
+
+		pClippedVertices[0] = v0;
+		pClippedVertices[1] = v1;
+		pClippedVertices[2] = v2;
+		int amountOfVertices{ 3 };
+
+		bool isClipped{ false };
+		Vertex_Out scratchVertices[m_MaxClippedVertices]{};
+		Vertex_Out* pInput{ pClippedVertices };
+		Vertex_Out* pOutput{ scratchVertices };
+
+		const auto lerpVertex = [](const Vertex_Out& from, const Vertex_Out& to, float t)
+			{
+				Vertex_Out vertex{};
+				vertex.position = from.position + ((to.position - from.position) * t);
+				vertex.color = from.color + ((to.color - from.color) * t);
+				vertex.uv = from.uv + ((to.uv - from.uv) * t);
+				vertex.normal = from.normal + ((to.normal - from.normal) * t);
+				vertex.viewDirection = from.viewDirection + ((to.viewDirection - from.viewDirection) * t);
+				return vertex;
+			};
+
+		for (const Vector4& plane : clipPlanes)
+		{
+			float distances[m_MaxClippedVertices]{};
+			bool isOutside{ false };
+
+			for (int vertexIdx{ 0 }; vertexIdx < amountOfVertices; ++vertexIdx)
+			{
+				distances[vertexIdx] = Vector4::Dot(plane, pInput[vertexIdx].position);
+				isOutside |= distances[vertexIdx] < 0.f;
+			}
+
+			if (!isOutside)
+			{
+				continue;
+			}
+
+			//Sutherland-Hodgman: keep the inside vertices, add an intersection for every edge that crosses the plane
+			int amountOfOutputVertices{ 0 };
+			for (int vertexIdx{ 0 }; vertexIdx < amountOfVertices; ++vertexIdx)
+			{
+				const int nextIdx{ (vertexIdx + 1) % amountOfVertices };
+				const float distance{ distances[vertexIdx] };
+				const float nextDistance{ distances[nextIdx] };
+
+				if (distance >= 0.f)
+				{
+					pOutput[amountOfOutputVertices++] = pInput[vertexIdx];
+				}
+
+				if ((distance >= 0.f) != (nextDistance >= 0.f))
+				{
+					pOutput[amountOfOutputVertices++] = lerpVertex(pInput[vertexIdx], pInput[nextIdx], distance / (distance - nextDistance));
+				}
+			}
+
+			std::swap(pInput, pOutput);
+			amountOfVertices = amountOfOutputVertices;
+			isClipped = true;
+
+			if (amountOfVertices < 3)
+			{
+				++m_TriangleStats.culled;
+				return 0;
+			}
+		}
+
+		if (pInput != pClippedVertices)
+		{
+			std::copy_n(pInput, amountOfVertices, pClippedVertices);
+		}
+
+		if (isClipped)
+		{
+			++m_TriangleStats.clipped;
+		}
+		else
+		{
+			++m_TriangleStats.accepted;
+		}
+
+		for (int vertexIdx{ 0 }; vertexIdx < amountOfVertices; ++vertexIdx)
+		{
+			ProjectToScreen(pClippedVertices[vertexIdx]);
+		}
+
+		return amountOfVertices;
+	}
+
+	void Renderer::ProjectToScreen(Vertex_Out& vertex) const
+	{
+		//clip to NDC space, w is kept for perspective correct interpolation
+		vertex.position.x /= vertex.position.w;
+		vertex.position.y /= vertex.position.w;
+		vertex.position.z /= vertex.position.w;
+
+		//projection to screen space
+		vertex.position.x = ((vertex.position.x + 1.f) / 2.f) * m_Width;
+		vertex.position.y = ((1.f - vertex.position.y) / 2.f) * m_Height;
+	}
+
+	bool Renderer::TriangleSetup(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, TriangleSetupRecord& setup) const
+	{
+		//snap the vertices to the sub-pixel grid, shared vertices snap to the same point so shared edges match exactly
+		const auto snap = [](float value)
+			{
+				return static_cast<int>(std::lround(value * m_SubPixelScale));
+			};
+
+		const int fixedX[3]{ snap(v0.position.x), snap(v1.position.x), snap(v2.position.x) };
+		const int fixedY[3]{ snap(v0.position.y), snap(v1.position.y), snap(v2.position.y) };
+
+		//tight bounding box: first and last pixel centre inside the snapped extents, clamped to screen
+		const int fixedMinX{ std::min({ fixedX[0], fixedX[1], fixedX[2] }) };
+		const int fixedMinY{ std::min({ fixedY[0], fixedY[1], fixedY[2] }) };
+		const int fixedMaxX{ std::max({ fixedX[0], fixedX[1], fixedX[2] }) };
+		const int fixedMaxY{ std::max({ fixedY[0], fixedY[1], fixedY[2] }) };
+
+		setup.minX = Clamp((fixedMinX - m_HalfPixel + m_SubPixelScale - 1) >> m_SubPixelBits, 0, m_Width);
+		setup.minY = Clamp((fixedMinY - m_HalfPixel + m_SubPixelScale - 1) >> m_SubPixelBits, 0, m_Height);
+		setup.maxX = Clamp(((fixedMaxX - m_HalfPixel) >> m_SubPixelBits) + 1, 0, m_Width);
+		setup.maxY = Clamp(((fixedMaxY - m_HalfPixel) >> m_SubPixelBits) + 1, 0, m_Height);
+
+		//covers no pixel centre at all
+		if (setup.minX >= setup.maxX || setup.minY >= setup.maxY)
+		{
+			++m_TriangleStats.degenerate;
+			return false;
+		}
+
+		setup.fixedOriginX = fixedX[0];
+		setup.fixedOriginY = fixedY[0];
+		setup.originX = static_cast<float>(fixedX[0]) / m_SubPixelScale;
+		setup.originY = static_cast<float>(fixedY[0]) / m_SubPixelScale;
+
+		//edge functions: edge i is the edge opposite of vertex i, Cross(v_end - v_start, p - v_start) written out as a * dx + b * dy + c
+		for (int edgeIdx{ 0 }; edgeIdx < 3; ++edgeIdx)
+		{
+			const int start{ (edgeIdx + 1) % 3 };
+			const int end{ (edgeIdx + 2) % 3 };
+
+			EdgeFunction& edge{ setup.edges[edgeIdx] };
+			edge.a = fixedY[start] - fixedY[end];
+			edge.b = fixedX[end] - fixedX[start];
+			edge.c = 0;
+		}
+
+		//only the edge opposite of the origin vertex is not zero there, its value is the signed (doubled) triangle area
+		int64_t fixedTriangleArea{ int64_t(setup.edges[0].a) * (fixedX[0] - fixedX[1]) + int64_t(setup.edges[0].b) * (fixedY[0] - fixedY[1]) };
+		if (fixedTriangleArea == 0)
+		{
+			++m_TriangleStats.degenerate;
+			return false;
+		}
+
+		//positive area is clockwise on screen, the front face for D3D's default FrontCounterClockwise = false
+		const bool isFrontFacing{ fixedTriangleArea > 0 };
+		if ((m_CullMode == CullModes::back && !isFrontFacing) || (m_CullMode == CullModes::front && isFrontFacing))
+		{
+			++m_TriangleStats.faceCulled;
+			return false;
+		}
+
+		//flip the edges of a back face that is drawn, so the inside is positive for both windings
+		if (!isFrontFacing)
+		{
+			for (EdgeFunction& edge : setup.edges)
+			{
+				edge.a = -edge.a;
+				edge.b = -edge.b;
+			}
+
+			fixedTriangleArea = -fixedTriangleArea;
+		}
+
+		setup.edges[0].c = static_cast<int>(fixedTriangleArea);
+
+		//top-left fill rule: a pixel centre exactly on an edge only belongs to the triangle if that edge is a top or left edge,
+		//so E >= 0 becomes E > 0 for the other edges
+		for (EdgeFunction& edge : setup.edges)
+		{
+			const bool isLeftEdge{ edge.a > 0 };
+			const bool isTopEdge{ edge.a == 0 && edge.b > 0 };
+
+			if (!isLeftEdge && !isTopEdge)
+			{
+				edge.c -= 1;
+			}
+		}
+
+		//a bounding box around a single pixel centre, test that sample here instead of in the raster loop
+		if (setup.maxX - setup.minX == 1 && setup.maxY - setup.minY == 1)
+		{
+			const int fixedSampleX{ (setup.minX << m_SubPixelBits) + m_HalfPixel - setup.fixedOriginX };
+			const int fixedSampleY{ (setup.minY << m_SubPixelBits) + m_HalfPixel - setup.fixedOriginY };
+
+			for (const EdgeFunction& edge : setup.edges)
+			{
+				if (edge.Evaluate(fixedSampleX, fixedSampleY) < 0)
+				{
+					++m_TriangleStats.degenerate;
+					return false;
+				}
+			}
+		}
+
+		//edge gradients in pixels, for the attribute planes
+		const float edge1A{ static_cast<float>(setup.edges[1].a) / m_SubPixelScale };
+		const float edge1B{ static_cast<float>(setup.edges[1].b) / m_SubPixelScale };
+		const float edge2A{ static_cast<float>(setup.edges[2].a) / m_SubPixelScale };
+		const float edge2B{ static_cast<float>(setup.edges[2].b) / m_SubPixelScale };
+		const float invTriangleArea{ static_cast<float>(m_SubPixelScale * m_SubPixelScale) / static_cast<float>(fixedTriangleArea) };
+
+		//plane through the three vertex values, weighted by the normalized barycentric coordinates
+		const auto makePlane = [&](float value0, float value1, float value2)
+			{
+				return PlaneEquation{
+					(edge1A * (value1 - value0) + edge2A * (value2 - value0)) * invTriangleArea,
+					(edge1B * (value1 - value0) + edge2B * (value2 - value0)) * invTriangleArea,
+					value0 };
+			};
+
+		//depth in NDC is linear in screen space
+		setup.z = makePlane(v0.position.z, v1.position.z, v2.position.z);
+		setup.minZ = std::min({ v0.position.z, v1.position.z, v2.position.z });
+		setup.maxZ = std::max({ v0.position.z, v1.position.z, v2.position.z });
+
+		//everything else is interpolated perspective correct: attribute / w and 1 / w are linear in screen space
+		const float invW0{ 1.f / v0.position.w };
+		const float invW1{ 1.f / v1.position.w };
+		const float invW2{ 1.f / v2.position.w };
+		setup.invW = makePlane(invW0, invW1, invW2);
+
+		setup.uvDivW[0] = makePlane(v0.uv.x * invW0, v1.uv.x * invW1, v2.uv.x * invW2);
+		setup.uvDivW[1] = makePlane(v0.uv.y * invW0, v1.uv.y * invW1, v2.uv.y * invW2);
+
+		setup.colourDivW[0] = makePlane(v0.color.r * invW0, v1.color.r * invW1, v2.color.r * invW2);
+		setup.colourDivW[1] = makePlane(v0.color.g * invW0, v1.color.g * invW1, v2.color.g * invW2);
+		setup.colourDivW[2] = makePlane(v0.color.b * invW0, v1.color.b * invW1, v2.color.b * invW2);
+
+		for (int axis{ 0 }; axis < 3; ++axis)
+		{
+			setup.normalDivW[axis] = makePlane(v0.normal[axis] * invW0, v1.normal[axis] * invW1, v2.normal[axis] * invW2);
+			setup.viewDirectionDivW[axis] = makePlane(v0.viewDirection[axis] * invW0, v1.viewDirection[axis] * invW1, v2.viewDirection[axis] * invW2);
+		}
+
+		++m_TriangleStats.rasterized;
+		return true;
+	}
+
+	void Renderer::RenderTile(Tile& tile, uint32_t clearColour) const
+	{
+		//Clear the tile's own colour and depth memory
+		std::fill_n(tile.pColourPixels, m_TileSize * m_TileSize, clearColour);
+		std::fill_n(tile.pDepthPixels, m_TileSize * m_TileSize, FLT_MAX);
+		std::fill_n(tile.pVisibilityPixels, m_TileSize * m_TileSize, m_EmptyVisibilityId);
+		std::fill_n(tile.hiZMin, m_HiZBlocksPerTile, FLT_MAX);
+		std::fill_n(tile.hiZMax, m_HiZBlocksPerTile, FLT_MAX);
+		tile.hiZDirtyBlocks = 0;
+
+		for (const uint32_t setupIdx : tile.bin)
+		{
+			switch (m_RasterizerKernel)
+			{
+			case RasterizerKernel::avx512:
+				TriangleHandelingAVX512(m_TriangleSetups[setupIdx], tile);
+				break;
+			case RasterizerKernel::avx2:
+				TriangleHandelingAVX2(m_TriangleSetups[setupIdx], tile);
+				break;
+			case RasterizerKernel::scalar:
+				TriangleHandeling(m_TriangleSetups[setupIdx], tile);
+				break;
+			}
+		}
+
+		//fragments still waiting for a full batch
+		ShadeFragmentBatch(tile);
+	}
+
+	void Renderer::ResolveTile(const Tile& tile) const
+	{
+		//Copy the finished tile into its rectangle of the back buffer
+		const int tileWidth{ tile.maxX - tile.minX };
+
+		for (int py{ tile.minY }; py < tile.maxY; ++py)
+		{
+			const uint32_t* pTileRow{ tile.pColourPixels + ((py - tile.minY) * m_TileSize) };
+			std::copy_n(pTileRow, tileWidth, m_pBackBufferPixels + tile.minX + (py * m_Width));
+		}
+
+		//counted as one copy, the rows are only split by the back buffer's pitch
+		AllocationTracker::CountCopy(size_t(tileWidth) * (tile.maxY - tile.minY) * sizeof(uint32_t));
+	}
+
+	void Renderer::TriangleHandeling(const TriangleSetupRecord& setup, Tile& tile) const
+	{
+		//bounding box clamped to tile
+		const int minX{ std::max(setup.minX, tile.minX) };
+		const int minY{ std::max(setup.minY, tile.minY) };
+		const int maxX{ std::min(setup.maxX, tile.maxX) };
+		const int maxY{ std::min(setup.maxY, tile.maxY) };
+
+		//quads start on even pixels, so the scalar and the AVX2 kernel agree on the quad grid
+		const int quadMinX{ minX & ~1 };
+		const int quadMinY{ minY & ~1 };
+
+		//edge functions and depth at the first quad's top left pixel centre, stepped incrementally from there
+		const int fixedStartX{ (quadMinX << m_SubPixelBits) + m_HalfPixel - setup.fixedOriginX };
+		const int fixedStartY{ (quadMinY << m_SubPixelBits) + m_HalfPixel - setup.fixedOriginY };
+		const float startX{ quadMinX + 0.5f - setup.originX };
+		const float startY{ quadMinY + 0.5f - setup.originY };
+
+		int rowW0{ setup.edges[0].Evaluate(fixedStartX, fixedStartY) };
+		int rowW1{ setup.edges[1].Evaluate(fixedStartX, fixedStartY) };
+		int rowW2{ setup.edges[2].Evaluate(fixedStartX, fixedStartY) };
+		float rowZ{ setup.z.Evaluate(startX, startY) };
+
+		for (int quadY{ quadMinY }; quadY < maxY; quadY += 2)
+		{
+			int w0{ rowW0 };
+			int w1{ rowW1 };
+			int w2{ rowW2 };
+			float z{ rowZ };
+
+			for (int quadX{ quadMinX }; quadX < maxX; quadX += 2)
+			{
+				Quad quad{ quadX, quadY };
+
+				for (int lane{ 0 }; lane < 4; ++lane)
+				{
+					const int laneX{ lane & 1 };
+					const int laneY{ lane >> 1 };
+					const int px{ quadX + laneX };
+					const int py{ quadY + laneY };
+
+					//lanes outside the bounding box can only be helper lanes
+					if (px < minX || px >= maxX || py < minY || py >= maxY)
+					{
+						continue;
+					}
+
+					const int laneW0{ w0 + (((setup.edges[0].a * laneX) + (setup.edges[0].b * laneY)) << m_SubPixelBits) };
+					const int laneW1{ w1 + (((setup.edges[1].a * laneX) + (setup.edges[1].b * laneY)) << m_SubPixelBits) };
+					const int laneW2{ w2 + (((setup.edges[2].a * laneX) + (setup.edges[2].b * laneY)) << m_SubPixelBits) };
+					const float laneZ{ z + (setup.z.a * laneX) + (setup.z.b * laneY) };
+
+					if (laneW0 >= 0 && laneW1 >= 0 && laneW2 >= 0 && ProcessRenderedTriangle(setup, laneZ, px, py, tile))
+					{
+						quad.coverageMask |= 1 << lane;
+						quad.depth[lane] = laneZ;
+					}
+				}
+
+				if (quad.coverageMask != 0 && m_ShadingPipeline == ShadingPipeline::forward)
+				{
+					QuadVaryings varyings{};
+					InterpolateQuad(setup, quadX, quadY, varyings);
+					ShadeQuad(quad, varyings, tile);
+				}
+
+				w0 += setup.edges[0].a << (m_SubPixelBits + 1);
+				w1 += setup.edges[1].a << (m_SubPixelBits + 1);
+				w2 += setup.edges[2].a << (m_SubPixelBits + 1);
+				z += setup.z.a * 2.f;
+			}
+
+			rowW0 += setup.edges[0].b << (m_SubPixelBits + 1);
+			rowW1 += setup.edges[1].b << (m_SubPixelBits + 1);
+			rowW2 += setup.edges[2].b << (m_SubPixelBits + 1);
+			rowZ += setup.z.b * 2.f;
+		}
+	}
+
+	void Renderer::TriangleHandelingAVX2(const TriangleSetupRecord& setup, Tile& tile) const
+	{
+		//bounding box clamped to tile
+		const int minX{ std::max(setup.minX, tile.minX) };
+		const int minY{ std::max(setup.minY, tile.minY) };
+		const int maxX{ std::min(setup.maxX, tile.maxX) };
+		const int maxY{ std::min(setup.maxY, tile.maxY) };
+
+		//pixel offsets of the 8 lanes in a 4x2 block: lanes 0-3 are the top row, lanes 4-7 the bottom row
+		const __m256 laneX{ _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 0.f, 1.f, 2.f, 3.f) };
+		const __m256 laneY{ _mm256_setr_ps(0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f) };
+		const __m256i laneXi{ _mm256_setr_epi32(0, 1, 2, 3, 0, 1, 2, 3) };
+		const __m256i laneYi{ _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1) };
+
+		const auto edgeLaneOffsets = [&](const EdgeFunction& edge)
+			{
+				return _mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(edge.a << m_SubPixelBits), laneXi),
+										_mm256_mullo_epi32(_mm256_set1_epi32(edge.b << m_SubPixelBits), laneYi));
+			};
+
+		const __m256i w0Offsets{ edgeLaneOffsets(setup.edges[0]) };
+		const __m256i w1Offsets{ edgeLaneOffsets(setup.edges[1]) };
+		const __m256i w2Offsets{ edgeLaneOffsets(setup.edges[2]) };
+		const __m256 zOffsets{ _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(setup.z.a), laneX), _mm256_mul_ps(_mm256_set1_ps(setup.z.b), laneY)) };
+
+		//stepping one 4x2 block to the right
+		const __m256i w0StepX{ _mm256_set1_epi32(setup.edges[0].a << (m_SubPixelBits + 2)) };
+		const __m256i w1StepX{ _mm256_set1_epi32(setup.edges[1].a << (m_SubPixelBits + 2)) };
+		const __m256i w2StepX{ _mm256_set1_epi32(setup.edges[2].a << (m_SubPixelBits + 2)) };
+		const __m256 zStepX{ _mm256_set1_ps(setup.z.a * 4.f) };
+
+		const __m256 zero{ _mm256_setzero_ps() };
+		const __m256 one{ _mm256_set1_ps(1.f) };
+		const __m256i minusOne{ _mm256_set1_epi32(-1) };
+		const __m256i maxXi{ _mm256_set1_epi32(maxX) };
+		const __m256i maxYi{ _mm256_set1_epi32(maxY) };
+
+		alignas(32) float zLanes[8]{};
+
+		//walk the hierarchical depth blocks the bounding box overlaps (tiles start on a multiple of the block size)
+		for (int blockY{ minY & ~(m_HiZBlockSize - 1) }; blockY < maxY; blockY += m_HiZBlockSize)
+		{
+			for (int blockX{ minX & ~(m_HiZBlockSize - 1) }; blockX < maxX; blockX += m_HiZBlockSize)
+			{
+				const int hiZIdx{ ((blockX - tile.minX) / m_HiZBlockSize) + (((blockY - tile.minY) / m_HiZBlockSize) * m_HiZBlocksPerRow) };
+				UpdateHiZBlock(tile, hiZIdx);
+
+				//the nearest point of the triangle is behind everything already in this block
+				if (setup.minZ > tile.hiZMax[hiZIdx])
+				{
+					continue;
+				}
+
+				//the farthest point of the triangle is in front of everything already in this block
+				const bool isInFront{ setup.maxZ <= tile.hiZMin[hiZIdx] };
+
+				//edge functions and depth at the first pixel centre of the block, stepped incrementally from there
+				const int fixedStartX{ (blockX << m_SubPixelBits) + m_HalfPixel - setup.fixedOriginX };
+				const int fixedStartY{ (blockY << m_SubPixelBits) + m_HalfPixel - setup.fixedOriginY };
+				const float startX{ blockX + 0.5f - setup.originX };
+				const float startY{ blockY + 0.5f - setup.originY };
+
+				int rowW0{ setup.edges[0].Evaluate(fixedStartX, fixedStartY) };
+				int rowW1{ setup.edges[1].Evaluate(fixedStartX, fixedStartY) };
+				int rowW2{ setup.edges[2].Evaluate(fixedStartX, fixedStartY) };
+				float rowZ{ setup.z.Evaluate(startX, startY) };
+
+				const int blockMaxX{ std::min(blockX + m_HiZBlockSize, maxX) };
+				const int blockMaxY{ std::min(blockY + m_HiZBlockSize, maxY) };
+
+				//row-major over the block, one 4x2 block at a time
+				for (int py{ blockY }; py < blockMaxY; py += 2)
+				{
+					__m256i w0{ _mm256_add_epi32(_mm256_set1_epi32(rowW0), w0Offsets) };
+					__m256i w1{ _mm256_add_epi32(_mm256_set1_epi32(rowW1), w1Offsets) };
+					__m256i w2{ _mm256_add_epi32(_mm256_set1_epi32(rowW2), w2Offsets) };
+					__m256 z{ _mm256_add_ps(_mm256_set1_ps(rowZ), zOffsets) };
+
+					const __m256i rowMask{ _mm256_cmpgt_epi32(maxYi, _mm256_add_epi32(_mm256_set1_epi32(py), laneYi)) };
+
+					for (int px{ blockX }; px < blockMaxX; px += 4)
+					{
+						//coverage: no edge function negative, and inside the clamped bounding box
+						__m256i inside{ _mm256_cmpgt_epi32(_mm256_or_si256(w0, _mm256_or_si256(w1, w2)), minusOne) };
+
+						const __m256i columnMask{ _mm256_cmpgt_epi32(maxXi, _mm256_add_epi32(_mm256_set1_epi32(px), laneXi)) };
+						inside = _mm256_and_si256(inside, _mm256_and_si256(rowMask, columnMask));
+
+						const __m256 coverage{ _mm256_castsi256_ps(inside) };
+						if (_mm256_movemask_ps(coverage) != 0)
+						{
+							//depth test against both rows of the block at once
+							float* pDepthTop{ tile.pDepthPixels + (px - tile.minX) + ((py - tile.minY) * m_TileSize) };
+							float* pDepthBottom{ pDepthTop + m_TileSize };
+							const __m256 depth{ _mm256_loadu2_m128(pDepthBottom, pDepthTop) };
+
+							__m256 passed{ _mm256_and_ps(coverage, _mm256_cmp_ps(z, zero, _CMP_GE_OQ)) };
+							passed = _mm256_and_ps(passed, _mm256_cmp_ps(z, one, _CMP_LE_OQ));
+							if (!isInFront)
+							{
+								passed = _mm256_and_ps(passed, _mm256_cmp_ps(z, depth, _CMP_LE_OQ));
+							}
+
+							const int passedMask{ _mm256_movemask_ps(passed) };
+							if (passedMask != 0)
+							{
+								_mm256_storeu2_m128(pDepthBottom, pDepthTop, _mm256_blendv_ps(depth, z, passed));
+								tile.hiZDirtyBlocks |= uint64_t(1) << hiZIdx;
+
+								if (m_ShadingPipeline == ShadingPipeline::visibilityBuffer)
+								{
+									//only remember which triangle won, shading happens once per pixel afterwards
+									__m128i* pVisibilityTop{ reinterpret_cast<__m128i*>(tile.pVisibilityPixels + (pDepthTop - tile.pDepthPixels)) };
+									__m128i* pVisibilityBottom{ reinterpret_cast<__m128i*>(tile.pVisibilityPixels + (pDepthBottom - tile.pDepthPixels)) };
+									const __m256i visibility{ _mm256_loadu2_m128i(pVisibilityBottom, pVisibilityTop) };
+
+									_mm256_storeu2_m128i(pVisibilityBottom, pVisibilityTop,
+										_mm256_blendv_epi8(visibility, _mm256_set1_epi32(setup.visibilityId), _mm256_castps_si256(passed)));
+								}
+								else
+								{
+									//the 4x2 block is two quads side by side: block lanes 0, 1, 4, 5 and 2, 3, 6, 7
+									_mm256_store_ps(zLanes, z);
+									for (int quadIdx{ 0 }; quadIdx < 2; ++quadIdx)
+									{
+										const int blockLane{ quadIdx * 2 };
+
+										Quad quad{ px + blockLane, py };
+										quad.coverageMask = ((passedMask >> blockLane) & 0b11) | (((passedMask >> (blockLane + 4)) & 0b11) << 2);
+										if (quad.coverageMask == 0)
+										{
+											continue;
+										}
+
+										quad.depth[0] = zLanes[blockLane];
+										quad.depth[1] = zLanes[blockLane + 1];
+										quad.depth[2] = zLanes[blockLane + 4];
+										quad.depth[3] = zLanes[blockLane + 5];
+
+										QuadVaryings varyings{};
+										InterpolateQuad(setup, quad.x, quad.y, varyings);
+										ShadeQuad(quad, varyings, tile);
+									}
+								}
+							}
+						}
+
+						w0 = _mm256_add_epi32(w0, w0StepX);
+						w1 = _mm256_add_epi32(w1, w1StepX);
+						w2 = _mm256_add_epi32(w2, w2StepX);
+						z = _mm256_add_ps(z, zStepX);
+					}
+
+					//stepping one 4x2 block down
+					rowW0 += setup.edges[0].b << (m_SubPixelBits + 1);
+					rowW1 += setup.edges[1].b << (m_SubPixelBits + 1);
+					rowW2 += setup.edges[2].b << (m_SubPixelBits + 1);
+					rowZ += setup.z.b * 2.f;
+				}
+			}
+		}
+	}
+
+	void Renderer::TriangleHandelingAVX512(const TriangleSetupRecord& setup, Tile& tile) const
+	{
+		static_assert(m_HiZBlockSize == 8, "one 8x2 block of lanes spans a hierarchical depth block");
+
+		//bounding box clamped to tile
+		const int minX{ std::max(setup.minX, tile.minX) };
+		const int minY{ std::max(setup.minY, tile.minY) };
+		const int maxX{ std::min(setup.maxX, tile.maxX) };
+		const int maxY{ std::min(setup.maxY, tile.maxY) };
+
+		//pixel offsets of the 16 lanes in an 8x2 block: lanes 0-7 are the top row, lanes 8-15 the bottom row
+		const __m512i laneXi{ _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7) };
+		const __m512i laneYi{ _mm512_setr_epi32(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1) };
+
+		const auto edgeLaneOffsets = [&](const EdgeFunction& edge)
+			{
+				return _mm512_add_epi32(_mm512_mullo_epi32(_mm512_set1_epi32(edge.a << m_SubPixelBits), laneXi),
+										_mm512_mullo_epi32(_mm512_set1_epi32(edge.b << m_SubPixelBits), laneYi));
+			};
+
+		const __m512i w0Offsets{ edgeLaneOffsets(setup.edges[0]) };
+		const __m512i w1Offsets{ edgeLaneOffsets(setup.edges[1]) };
+		const __m512i w2Offsets{ edgeLaneOffsets(setup.edges[2]) };
+
+		//depth is stepped like the AVX2 kernel does it, the right half of the row is its left half plus four steps to the right.
+		//Both kernels round the same way and write the same depth
+		const __m512 laneX{ _mm512_setr_ps(0.f, 1.f, 2.f, 3.f, 0.f, 1.f, 2.f, 3.f, 0.f, 1.f, 2.f, 3.f, 0.f, 1.f, 2.f, 3.f) };
+		const __m512 laneY{ _mm512_setr_ps(0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f) };
+		const __m512 zOffsets{ _mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(setup.z.a), laneX), _mm512_mul_ps(_mm512_set1_ps(setup.z.b), laneY)) };
+		const __m512 zRightHalf{ _mm512_maskz_mov_ps(0xF0F0, _mm512_set1_ps(setup.z.a * 4.f)) };
+
+		const __m512 zero{ _mm512_setzero_ps() };
+		const __m512 one{ _mm512_set1_ps(1.f) };
+		const __m512i minusOne{ _mm512_set1_epi32(-1) };
+		const __m512i maxXi{ _mm512_set1_epi32(maxX) };
+		const __m512i maxYi{ _mm512_set1_epi32(maxY) };
+		const __m256i visibilityId{ _mm256_set1_epi32(setup.visibilityId) };
+
+		alignas(64) float zLanes[16]{};
+
+		//walk the hierarchical depth blocks the bounding box overlaps, one 8x2 block covers a block row pair
+		for (int blockY{ minY & ~(m_HiZBlockSize - 1) }; blockY < maxY; blockY += m_HiZBlockSize)
+		{
+			for (int blockX{ minX & ~(m_HiZBlockSize - 1) }; blockX < maxX; blockX += m_HiZBlockSize)
+			{
+				const int hiZIdx{ ((blockX - tile.minX) / m_HiZBlockSize) + (((blockY - tile.minY) / m_HiZBlockSize) * m_HiZBlocksPerRow) };
+				UpdateHiZBlock(tile, hiZIdx);
+
+				if (setup.minZ > tile.hiZMax[hiZIdx])
+				{
+					continue;
+				}
+
+				const bool isInFront{ setup.maxZ <= tile.hiZMin[hiZIdx] };
+
+				const int fixedStartX{ (blockX << m_SubPixelBits) + m_HalfPixel - setup.fixedOriginX };
+				const int fixedStartY{ (blockY << m_SubPixelBits) + m_HalfPixel - setup.fixedOriginY };
+				const float startX{ blockX + 0.5f - setup.originX };
+				const float startY{ blockY + 0.5f - setup.originY };
+
+				int rowW0{ setup.edges[0].Evaluate(fixedStartX, fixedStartY) };
+				int rowW1{ setup.edges[1].Evaluate(fixedStartX, fixedStartY) };
+				int rowW2{ setup.edges[2].Evaluate(fixedStartX, fixedStartY) };
+				float rowZ{ setup.z.Evaluate(startX, startY) };
+
+				const __mmask16 columnMask{ _mm512_cmpgt_epi32_mask(maxXi, _mm512_add_epi32(_mm512_set1_epi32(blockX), laneXi)) };
+				const int blockMaxY{ std::min(blockY + m_HiZBlockSize, maxY) };
+
+				for (int py{ blockY }; py < blockMaxY; py += 2)
+				{
+					const __m512i w0{ _mm512_add_epi32(_mm512_set1_epi32(rowW0), w0Offsets) };
+					const __m512i w1{ _mm512_add_epi32(_mm512_set1_epi32(rowW1), w1Offsets) };
+					const __m512i w2{ _mm512_add_epi32(_mm512_set1_epi32(rowW2), w2Offsets) };
+					const __m512 z{ _mm512_add_ps(_mm512_add_ps(_mm512_set1_ps(rowZ), zOffsets), zRightHalf) };
+
+					//stepping one 8x2 block down
+					rowW0 += setup.edges[0].b << (m_SubPixelBits + 1);
+					rowW1 += setup.edges[1].b << (m_SubPixelBits + 1);
+					rowW2 += setup.edges[2].b << (m_SubPixelBits + 1);
+					rowZ += setup.z.b * 2.f;
+
+					const __mmask16 rowMask{ _mm512_cmpgt_epi32_mask(maxYi, _mm512_add_epi32(_mm512_set1_epi32(py), laneYi)) };
+					const __mmask16 coverage{ static_cast<__mmask16>(_mm512_cmpgt_epi32_mask(_mm512_or_si512(w0, _mm512_or_si512(w1, w2)), minusOne) & rowMask & columnMask) };
+					if (coverage == 0)
+					{
+						continue;
+					}
+
+					float* pDepthTop{ tile.pDepthPixels + (blockX - tile.minX) + ((py - tile.minY) * m_TileSize) };
+					float* pDepthBottom{ pDepthTop + m_TileSize };
+					const __m512 depth{ _mm512_insertf32x8(_mm512_castps256_ps512(_mm256_loadu_ps(pDepthTop)), _mm256_loadu_ps(pDepthBottom), 1) };
+
+					__mmask16 passed{ _mm512_mask_cmp_ps_mask(coverage, z, zero, _CMP_GE_OQ) };
+					passed = _mm512_mask_cmp_ps_mask(passed, z, one, _CMP_LE_OQ);
+					if (!isInFront)
+					{
+						passed = _mm512_mask_cmp_ps_mask(passed, z, depth, _CMP_LE_OQ);
+					}
+
+					if (passed == 0)
+					{
+						continue;
+					}
+
+					const __mmask8 passedTop{ static_cast<__mmask8>(passed & 0xFF) };
+					const __mmask8 passedBottom{ static_cast<__mmask8>(passed >> 8) };
+					_mm256_mask_storeu_ps(pDepthTop, passedTop, _mm512_castps512_ps256(z));
+					_mm256_mask_storeu_ps(pDepthBottom, passedBottom, _mm512_extractf32x8_ps(z, 1));
+					tile.hiZDirtyBlocks |= uint64_t(1) << hiZIdx;
+
+					if (m_ShadingPipeline == ShadingPipeline::visibilityBuffer)
+					{
+						uint32_t* pVisibilityTop{ tile.pVisibilityPixels + (pDepthTop - tile.pDepthPixels) };
+						_mm256_mask_storeu_epi32(pVisibilityTop, passedTop, visibilityId);
+						_mm256_mask_storeu_epi32(pVisibilityTop + m_TileSize, passedBottom, visibilityId);
+						continue;
+					}
+
+					//the 8x2 block is four quads side by side, quad q is block lanes 2q, 2q + 1, 2q + 8 and 2q + 9
+					_mm512_store_ps(zLanes, z);
+					for (int quadIdx{ 0 }; quadIdx < 4; ++quadIdx)
+					{
+						const int blockLane{ quadIdx * 2 };
+
+						Quad quad{ blockX + blockLane, py };
+						quad.coverageMask = ((passed >> blockLane) & 0b11) | (((passed >> (blockLane + 8)) & 0b11) << 2);
+						if (quad.coverageMask == 0)
+						{
+							continue;
+						}
+
+						quad.depth[0] = zLanes[blockLane];
+						quad.depth[1] = zLanes[blockLane + 1];
+						quad.depth[2] = zLanes[blockLane + 8];
+						quad.depth[3] = zLanes[blockLane + 9];
+
+						QuadVaryings varyings{};
+						InterpolateQuad(setup, quad.x, quad.y, varyings);
+						ShadeQuad(quad, varyings, tile);
+					}
+				}
+			}
+		}
+	}
+
+	void Renderer::UpdateHiZBlock(Tile& tile, int hiZIdx) const
+	{
+		const uint64_t blockBit{ uint64_t(1) << hiZIdx };
+		if ((tile.hiZDirtyBlocks & blockBit) == 0)
+		{
+			return;
+		}
+
+		//reduce the 8 rows of the block to their nearest and farthest depth
+		const float* pDepth{ tile.pDepthPixels + ((hiZIdx % m_HiZBlocksPerRow) * m_HiZBlockSize) + ((hiZIdx / m_HiZBlocksPerRow) * m_HiZBlockSize * m_TileSize) };
+
+		//SSE so it runs on every instruction set, a row is its left and right half
+		__m128 minDepth{ _mm_min_ps(_mm_loadu_ps(pDepth), _mm_loadu_ps(pDepth + 4)) };
+		__m128 maxDepth{ _mm_max_ps(_mm_loadu_ps(pDepth), _mm_loadu_ps(pDepth + 4)) };
+		for (int row{ 1 }; row < m_HiZBlockSize; ++row)
+		{
+			const __m128 left{ _mm_loadu_ps(pDepth + (row * m_TileSize)) };
+			const __m128 right{ _mm_loadu_ps(pDepth + (row * m_TileSize) + 4) };
+			minDepth = _mm_min_ps(minDepth, _mm_min_ps(left, right));
+			maxDepth = _mm_max_ps(maxDepth, _mm_max_ps(left, right));
+		}
+
+		alignas(16) float minLanes[4]{};
+		alignas(16) float maxLanes[4]{};
+		_mm_store_ps(minLanes, minDepth);
+		_mm_store_ps(maxLanes, maxDepth);
+
+		tile.hiZMin[hiZIdx] = *std::min_element(std::begin(minLanes), std::end(minLanes));
+		tile.hiZMax[hiZIdx] = *std::max_element(std::begin(maxLanes), std::end(maxLanes));
+		tile.hiZDirtyBlocks &= ~blockBit;
+	}
+
+	bool Renderer::ProcessRenderedTriangle(const TriangleSetupRecord& setup, float zBufferValue, int px, int py, Tile& tile) const
+	{
+		//variables
+		const int bufferIdx{ (px - tile.minX) + ((py - tile.minY) * m_TileSize) };
+
+		//check if value is in range of [0,1]
+		if (0.f > zBufferValue || zBufferValue > 1.f)
+		{
+			return false;
+		}
+
+		if (zBufferValue > tile.pDepthPixels[bufferIdx])
+		{
+			return false;
+		}
+
+		tile.pDepthPixels[bufferIdx] = zBufferValue;
+
+		const int hiZIdx{ ((px - tile.minX) / m_HiZBlockSize) + (((py - tile.minY) / m_HiZBlockSize) * m_HiZBlocksPerRow) };
+		tile.hiZDirtyBlocks |= uint64_t(1) << hiZIdx;
+
+		if (m_ShadingPipeline == ShadingPipeline::visibilityBuffer)
+		{
+			tile.pVisibilityPixels[bufferIdx] = setup.visibilityId;
+		}
+
+		return true;
+	}
+
+	void Renderer::InterpolateQuad(const TriangleSetupRecord& setup, int quadX, int quadY, QuadVaryings& varyings) const
+	{
+		//intepolate vertex attributes with correct depth for all four lanes at once, helper lanes included,
+		//the only division left per pixel
+		const __m128 x{ _mm_add_ps(_mm_set1_ps(quadX + 0.5f - setup.originX), _mm_setr_ps(0.f, 1.f, 0.f, 1.f)) };
+		const __m128 y{ _mm_add_ps(_mm_set1_ps(quadY + 0.5f - setup.originY), _mm_setr_ps(0.f, 0.f, 1.f, 1.f)) };
+
+		const auto evaluate = [&](const PlaneEquation& plane)
+			{
+				return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.a), x), _mm_mul_ps(_mm_set1_ps(plane.b), y)), _mm_set1_ps(plane.c));
+			};
+
+		const __m128 w{ _mm_div_ps(_mm_set1_ps(1.f), evaluate(setup.invW)) };
+
+		const auto interpolate = [&](const PlaneEquation& plane, float (&lanes)[4])
+			{
+				_mm_storeu_ps(lanes, _mm_mul_ps(evaluate(plane), w));
+			};
+
+		interpolate(setup.uvDivW[0], varyings.u);
+		interpolate(setup.uvDivW[1], varyings.v);
+
+		for (int component{ 0 }; component < 3; ++component)
+		{
+			interpolate(setup.colourDivW[component], varyings.colour[component]);
+			interpolate(setup.normalDivW[component], varyings.normal[component]);
+			interpolate(setup.viewDirectionDivW[component], varyings.viewDirection[component]);
+		}
+
+		GetNormalMatrix(setup.visibilityId, varyings.normalMatrix);
+	}
+
+	bool Renderer::IsVisibilityBufferCurrent() const
+	{
+		if (!m_IsVisibilityBufferValid || m_pMeshObjects.size() != m_VisibilityWorldViewProjections.size())
+		{
+			return false;
+		}
+
+		const Matrix viewProjectionMatrix{ m_pCamera->GetViewMatrix() * m_pCamera->GetProjectionMatrix() };
+		for (size_t meshIdx{ 0 }; meshIdx < m_pMeshObjects.size(); ++meshIdx)
+		{
+			if (m_pMeshObjects[meshIdx]->GetWorldMatrix() * viewProjectionMatrix != m_VisibilityWorldViewProjections[meshIdx])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void Renderer::ShadeVisibilityTile(Tile& tile, uint32_t clearColour) const
+	{
+		//every visible pixel is shaded exactly once, no matter how many triangles were drawn over it
+		for (int quadY{ tile.minY }; quadY < tile.maxY; quadY += 2)
+		{
+			for (int quadX{ tile.minX }; quadX < tile.maxX; quadX += 2)
+			{
+				uint32_t visibilityIds[4]{};
+				int remainingMask{};
+
+				for (int lane{ 0 }; lane < 4; ++lane)
+				{
+					const int px{ quadX + (lane & 1) };
+					const int py{ quadY + (lane >> 1) };
+					if (px >= tile.maxX || py >= tile.maxY)
+					{
+						continue;
+					}
+
+					const int bufferIdx{ (px - tile.minX) + ((py - tile.minY) * m_TileSize) };
+					visibilityIds[lane] = tile.pVisibilityPixels[bufferIdx];
+
+					if (visibilityIds[lane] == m_EmptyVisibilityId)
+					{
+						tile.pColourPixels[bufferIdx] = clearColour;
+						continue;
+					}
+
+					remainingMask |= 1 << lane;
+				}
+
+				//one quad per triangle seen in it, the lanes of the other triangles become its helper lanes
+				while (remainingMask != 0)
+				{
+					const uint32_t visibilityId{ visibilityIds[std::countr_zero(static_cast<unsigned int>(remainingMask))] };
+
+					Quad quad{ quadX, quadY };
+					for (int lane{ 0 }; lane < 4; ++lane)
+					{
+						if ((remainingMask & (1 << lane)) != 0 && visibilityIds[lane] == visibilityId)
+						{
+							quad.coverageMask |= 1 << lane;
+							quad.depth[lane] = tile.pDepthPixels[(quadX + (lane & 1) - tile.minX) + ((quadY + (lane >> 1) - tile.minY) * m_TileSize)];
+						}
+					}
+					remainingMask &= ~quad.coverageMask;
+
+					QuadVaryings varyings{};
+					InterpolateVisibleQuad(visibilityId, quadX, quadY, varyings);
+					ShadeQuad(quad, varyings, tile);
+				}
+			}
+		}
+
+		ShadeFragmentBatch(tile);
+	}
+
+	void Renderer::InterpolateVisibleQuad(uint32_t visibilityId, int quadX, int quadY, QuadVaryings& varyings) const
+	{
+		//unpack the id to the triangle's transformed vertices
+		Mesh* pMesh{ m_pMeshObjects[visibilityId >> m_VisibilityTriangleBits] };
+		const uint32_t triangleIdx{ visibilityId & m_VisibilityTriangleMask };
+
+		const auto meshIndices = pMesh->GetMeshIndices();
+		const auto meshVerticesOut = pMesh->GetMeshVerticesOut();
+
+		const Vertex_Out& v0 = meshVerticesOut[meshIndices[(triangleIdx * 3) + 0]];
+		const Vertex_Out& v1 = meshVerticesOut[meshIndices[(triangleIdx * 3) + 1]];
+		const Vertex_Out& v2 = meshVerticesOut[meshIndices[(triangleIdx * 3) + 2]];
+
+		//the vertices are still in clip space, so the barycentric coordinates are reconstructed homogeneously:
+		//the clip space point seen through a pixel is weight0 * v0 + weight1 * v1 + weight2 * v2 (x, y and w only),
+		//which also works for triangles that were clipped against the near plane
+		const Vector3 position0{ v0.position.x, v0.position.y, v0.position.w };
+		const Vector3 position1{ v1.position.x, v1.position.y, v1.position.w };
+		const Vector3 position2{ v2.position.x, v2.position.y, v2.position.w };
+		const Vector3 edge0{ Vector3::Cross(position1, position2) };
+		const Vector3 edge1{ Vector3::Cross(position2, position0) };
+		const Vector3 edge2{ Vector3::Cross(position0, position1) };
+
+		//already perspective correct, for all four lanes at once, helper lanes included
+		const __m128 pixelX{ _mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_set1_ps(quadX + 0.5f), _mm_setr_ps(0.f, 1.f, 0.f, 1.f)), _mm_set1_ps(2.f / m_Width)), _mm_set1_ps(1.f)) };
+		const __m128 pixelY{ _mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(_mm_add_ps(_mm_set1_ps(quadY + 0.5f), _mm_setr_ps(0.f, 0.f, 1.f, 1.f)), _mm_set1_ps(2.f / m_Height))) };
+
+		const auto unnormalizedWeight = [&](const Vector3& edge)
+			{
+				return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(edge.x), pixelX), _mm_mul_ps(_mm_set1_ps(edge.y), pixelY)), _mm_set1_ps(edge.z));
+			};
+
+		const __m128 unnormalizedWeight0{ unnormalizedWeight(edge0) };
+		const __m128 unnormalizedWeight1{ unnormalizedWeight(edge1) };
+		const __m128 unnormalizedWeight2{ unnormalizedWeight(edge2) };
+		const __m128 invWeightSum{ _mm_div_ps(_mm_set1_ps(1.f), _mm_add_ps(_mm_add_ps(unnormalizedWeight0, unnormalizedWeight1), unnormalizedWeight2)) };
+
+		const __m128 weight0{ _mm_mul_ps(unnormalizedWeight0, invWeightSum) };
+		const __m128 weight1{ _mm_mul_ps(unnormalizedWeight1, invWeightSum) };
+		const __m128 weight2{ _mm_mul_ps(unnormalizedWeight2, invWeightSum) };
+
+		const auto interpolate = [&](float value0, float value1, float value2, float (&lanes)[4])
+			{
+				_mm_storeu_ps(lanes, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(value0), weight0), _mm_mul_ps(_mm_set1_ps(value1), weight1)), _mm_mul_ps(_mm_set1_ps(value2), weight2)));
+			};
+
+		interpolate(v0.uv.x, v1.uv.x, v2.uv.x, varyings.u);
+		interpolate(v0.uv.y, v1.uv.y, v2.uv.y, varyings.v);
+
+		interpolate(v0.color.r, v1.color.r, v2.color.r, varyings.colour[0]);
+		interpolate(v0.color.g, v1.color.g, v2.color.g, varyings.colour[1]);
+		interpolate(v0.color.b, v1.color.b, v2.color.b, varyings.colour[2]);
+
+		interpolate(v0.normal.x, v1.normal.x, v2.normal.x, varyings.normal[0]);
+		interpolate(v0.normal.y, v1.normal.y, v2.normal.y, varyings.normal[1]);
+		interpolate(v0.normal.z, v1.normal.z, v2.normal.z, varyings.normal[2]);
+
+		interpolate(v0.viewDirection.x, v1.viewDirection.x, v2.viewDirection.x, varyings.viewDirection[0]);
+		interpolate(v0.viewDirection.y, v1.viewDirection.y, v2.viewDirection.y, varyings.viewDirection[1]);
+		interpolate(v0.viewDirection.z, v1.viewDirection.z, v2.viewDirection.z, varyings.viewDirection[2]);
+
+		GetNormalMatrix(visibilityId, varyings.normalMatrix);
+	}
+
+	void Renderer::GetNormalMatrix(uint32_t visibilityId, float (&normalMatrix)[9]) const
+	{
+		//meshes without a baked normal map only have their world matrix
+		Mesh* pMesh{ m_pMeshObjects[visibilityId >> m_VisibilityTriangleBits] };
+		const std::span<const Matrix> normalMatrices{ pMesh->GetNormalMatricesOut() };
+		const uint32_t triangleIdx{ visibilityId & m_VisibilityTriangleMask };
+
+		const Matrix matrix{ triangleIdx < normalMatrices.size() ? normalMatrices[triangleIdx] : pMesh->GetWorldMatrix() };
+		for (int row{ 0 }; row < 3; ++row)
+		{
+			const Vector4 matrixRow{ matrix[row] };
+			normalMatrix[(row * 3) + 0] = matrixRow.x;
+			normalMatrix[(row * 3) + 1] = matrixRow.y;
+			normalMatrix[(row * 3) + 2] = matrixRow.z;
+		}
+	}
+
+	void Renderer::ShadeQuad(const Quad& quad, QuadVaryings& varyings, Tile& tile) const
+	{
+		//coarse derivatives shared by the whole quad: the top right and the bottom left lane minus the top left one
+		const Vector2 uvDdx{ varyings.u[1] - varyings.u[0], varyings.v[1] - varyings.v[0] };
+		const Vector2 uvDdy{ varyings.u[2] - varyings.u[0], varyings.v[2] - varyings.v[0] };
+
+		//normalize the direction varyings of all four lanes at once
+		const auto normalize = [](float (&vector)[3][4])
+			{
+				const __m128 x{ _mm_loadu_ps(vector[0]) };
+				const __m128 y{ _mm_loadu_ps(vector[1]) };
+				const __m128 z{ _mm_loadu_ps(vector[2]) };
+				const __m128 length{ _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z))) };
+
+				_mm_storeu_ps(vector[0], _mm_div_ps(x, length));
+				_mm_storeu_ps(vector[1], _mm_div_ps(y, length));
+				_mm_storeu_ps(vector[2], _mm_div_ps(z, length));
+			};
+
+		normalize(varyings.normal);
+		normalize(varyings.viewDirection);
+
+		//covered lanes join the tile's batch, clamp interpolated uv value between [0, 1]
+		FragmentBatch& batch{ tile.fragmentBatch };
+
+		int coverageMask{ quad.coverageMask };
+		while (coverageMask != 0)
+		{
+			const int lane{ std::countr_zero(static_cast<unsigned int>(coverageMask)) };
+			coverageMask &= coverageMask - 1;
+
+			const int batchLane{ batch.count++ };
+			batch.bufferIdx[batchLane] = (quad.x + (lane & 1) - tile.minX) + ((quad.y + (lane >> 1) - tile.minY) * m_TileSize);
+			batch.depth[batchLane] = quad.depth[lane];
+			batch.u[batchLane] = Clamp(varyings.u[lane], 0.f, 1.f);
+			batch.v[batchLane] = Clamp(varyings.v[lane], 0.f, 1.f);
+			batch.uvDdx[0][batchLane] = uvDdx.x;
+			batch.uvDdx[1][batchLane] = uvDdx.y;
+			batch.uvDdy[0][batchLane] = uvDdy.x;
+			batch.uvDdy[1][batchLane] = uvDdy.y;
+
+			for (int component{ 0 }; component < 3; ++component)
+			{
+				batch.normal[component][batchLane] = varyings.normal[component][lane];
+				batch.viewDirection[component][batchLane] = varyings.viewDirection[component][lane];
+			}
+
+			for (int element{ 0 }; element < 9; ++element)
+			{
+				batch.normalMatrix[element][batchLane] = varyings.normalMatrix[element];
+			}
+
+			if (batch.count == m_ShadingLanes)
+			{
+				ShadeFragmentBatch(tile);
+			}
+		}
+	}
+
+	void Renderer::ShadeFragmentBatch(Tile& tile) const
+	{
+		FragmentBatch& batch{ tile.fragmentBatch };
+		if (batch.count == 0)
+		{
+			return;
+		}
+
+		float colours[3][m_ShadingLanes]{};
+
+		switch (m_RenderMode)
+		{
+		case RenderMode::finalColour:
+		case RenderMode::finalColourSRGB:
+			//the batch is 8 lanes, the AVX-512 kernel shades it with AVX2 as well
+			if (m_RasterizerKernel != RasterizerKernel::scalar)
+			{
+				PixelShadingAVX2(batch, colours);
+				break;
+			}
+
+			//scalar reference, one lane at a time
+			for (int lane{ 0 }; lane < batch.count; ++lane)
+			{
+				Vertex_Out vertexOut{};
+				vertexOut.uv = Vector2{ batch.u[lane], batch.v[lane] };
+				vertexOut.normal = Vector3{ batch.normal[0][lane], batch.normal[1][lane], batch.normal[2][lane] };
+				vertexOut.viewDirection = Vector3{ batch.viewDirection[0][lane], batch.viewDirection[1][lane], batch.viewDirection[2][lane] };
+
+				const Matrix normalMatrix{
+					Vector3{ batch.normalMatrix[0][lane], batch.normalMatrix[1][lane], batch.normalMatrix[2][lane] },
+					Vector3{ batch.normalMatrix[3][lane], batch.normalMatrix[4][lane], batch.normalMatrix[5][lane] },
+					Vector3{ batch.normalMatrix[6][lane], batch.normalMatrix[7][lane], batch.normalMatrix[8][lane] },
+					Vector3{ 0.f, 0.f, 0.f } };
+
+				const ColorRGB colour{ PixelShading(vertexOut, normalMatrix,
+					Vector2{ batch.uvDdx[0][lane], batch.uvDdx[1][lane] },
+					Vector2{ batch.uvDdy[0][lane], batch.uvDdy[1][lane] }) };
+
+				colours[0][lane] = colour.r;
+				colours[1][lane] = colour.g;
+				colours[2][lane] = colour.b;
+			}
+			break;
+		case RenderMode::depthBuffer:
+			for (int lane{ 0 }; lane < batch.count; ++lane)
+			{
+				const float zBufferValue{ Remap(batch.depth[lane], 0.995f, 1.f) };
+				colours[0][lane] = zBufferValue;
+				colours[1][lane] = zBufferValue;
+				colours[2][lane] = zBufferValue;
+			}
+			break;
+		}
+
+		uint32_t pixels[m_ShadingLanes]{};
+		if (m_RasterizerKernel != RasterizerKernel::scalar)
+		{
+			PackColoursAVX2(colours, pixels);
+		}
+		else
+		{
+			PackColours(colours, pixels);
+		}
+
+		//in lane order, so a pixel drawn twice in one batch keeps its last colour
+		for (int lane{ 0 }; lane < batch.count; ++lane)
+		{
+			tile.pColourPixels[batch.bufferIdx[lane]] = pixels[lane];
+		}
+
+		batch.count = 0;
+	}
+
+	uint32_t Renderer::PackColour(uint8_t red, uint8_t green, uint8_t blue) const
+	{
+		return (uint32_t(red) << m_OutputFormat.redShift) | (uint32_t(green) << m_OutputFormat.greenShift) | (uint32_t(blue) << m_OutputFormat.blueShift) | m_OutputFormat.alphaMask;
+	}
+
+	void Renderer::PackColours(const float (&colours)[3][m_ShadingLanes], uint32_t (&pixels)[m_ShadingLanes]) const
+	{
+		for (int lane{ 0 }; lane < m_ShadingLanes; ++lane)
+		{
+			//negative and NaN channels become zero like _mm256_max_ps with zero does
+			float channels[3]{};
+			for (int channel{ 0 }; channel < 3; ++channel)
+			{
+				channels[channel] = colours[channel][lane] > 0.f ? colours[channel][lane] : 0.f;
+			}
+
+			const float maxValue{ std::max(std::max(channels[0], channels[1]), std::max(channels[2], 1.f)) };
+
+			uint8_t bytes[3]{};
+			for (int channel{ 0 }; channel < 3; ++channel)
+			{
+				const float value{ channels[channel] / maxValue };
+				bytes[channel] = m_RenderMode == RenderMode::finalColourSRGB ? static_cast<uint8_t>(m_SRGBTable[std::lrint(value * float(m_SRGBTableSize - 1))]) : static_cast<uint8_t>(value * 255.f);
+			}
+
+			pixels[lane] = PackColour(bytes[0], bytes[1], bytes[2]);
+		}
+	}
+
+	void Renderer::PackColoursAVX2(const float (&colours)[3][m_ShadingLanes], uint32_t (&pixels)[m_ShadingLanes]) const
+	{
+		const __m256 zero{ _mm256_setzero_ps() };
+		__m256 red{ _mm256_max_ps(_mm256_loadu_ps(colours[0]), zero) };
+		__m256 green{ _mm256_max_ps(_mm256_loadu_ps(colours[1]), zero) };
+		__m256 blue{ _mm256_max_ps(_mm256_loadu_ps(colours[2]), zero) };
+
+		//ColorRGB::MaxToOne for all lanes, a brightest channel above one scales the others down with it
+		const __m256 maxValue{ _mm256_max_ps(_mm256_max_ps(red, green), _mm256_max_ps(blue, _mm256_set1_ps(1.f))) };
+		red = _mm256_div_ps(red, maxValue);
+		green = _mm256_div_ps(green, maxValue);
+		blue = _mm256_div_ps(blue, maxValue);
+
+		const auto toByte = [&](__m256 channel)
+			{
+				if (m_RenderMode == RenderMode::finalColourSRGB)
+				{
+					const __m256i tableIdx{ _mm256_cvtps_epi32(_mm256_mul_ps(channel, _mm256_set1_ps(float(m_SRGBTableSize - 1)))) };
+					return _mm256_i32gather_epi32(m_SRGBTable.data(), tableIdx, sizeof(int));
+				}
+
+				//truncated like a cast
+				return _mm256_cvttps_epi32(_mm256_mul_ps(channel, _mm256_set1_ps(255.f)));
+			};
+
+		__m256i packed{ _mm256_set1_epi32(static_cast<int>(m_OutputFormat.alphaMask)) };
+		packed = _mm256_or_si256(packed, _mm256_sll_epi32(toByte(red), _mm_cvtsi32_si128(m_OutputFormat.redShift)));
+		packed = _mm256_or_si256(packed, _mm256_sll_epi32(toByte(green), _mm_cvtsi32_si128(m_OutputFormat.greenShift)));
+		packed = _mm256_or_si256(packed, _mm256_sll_epi32(toByte(blue), _mm_cvtsi32_si128(m_OutputFormat.blueShift)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels), packed);
+	}
+
+	float Renderer::Remap(float value, float inputMin, float inputMax) const
+	{
+		const float temp{ (value - inputMin) / (inputMax - inputMin) }; 
+		return temp; 
+	}
+
+	ColorRGB Renderer::PixelShading(const Vertex_Out& v, const Matrix& normalMatrix, const Vector2& uvDdx, const Vector2& uvDdy) const
+	{
+		//const variables
+		const ColorRGB ambient{ m_Ambient, m_Ambient, m_Ambient };
+		const Vector3 lightDirection{ m_LightDirection[0], m_LightDirection[1], m_LightDirection[2] };
+		const float lightIntensity{ m_LightIntensity };
+		const float diffuseCoeffient{ m_DiffuseCoefficient };
+
+		//variables
+		float observedArea{};
+		ColorRGB finalColour{};
+
+		//sample all texture maps in one fetch
+		const MaterialTexture::MaterialSample material{ m_pVehicleMaterial->Sample(v.uv, uvDdx, uvDdy, GetSoftwareSampler()) };
+		const ColorRGB diffuseColour{ material.diffuse }; 
+		const ColorRGB specularColour{ material.specular, material.specular, material.specular }; 
+
+		//the normal map is baked to object space, one matrix brings it to world space
+		const Vector3 sampledNormal{ normalMatrix.TransformVector(material.normal).Normalized() };
+
+		// Calculate observed area
+		if (m_IsNormalMapOn)
+		{
+			//observed area
+			observedArea = Vector3::Dot(sampledNormal, -lightDirection);
+		}
+		else
+		{
+			//observed area
+			observedArea = Vector3::Dot(v.normal, -lightDirection);
+		}
+
+		if (observedArea <= 0)
+		{
+			return ColorRGB{ 0.f, 0.f, 0.f };
+		}
+
+		//calculate lambert diffuse
+		const ColorRGB lambertDiffuse{ (diffuseCoeffient * diffuseColour) / float(M_PI) };
+
+		//calculate phong reflection
+		const Vector3 reflect{ lightDirection - (2.f * Vector3::Dot(sampledNormal, lightDirection) * sampledNormal) };
+		const float angle{ std::max(0.f, Vector3::Dot(reflect, -v.viewDirection)) };
+
+		//pow(angle, glossiness * shininess)
+		float phong{};
+		switch (m_SpecularPowerMode)
+		{
+		case SpecularPowerMode::powf:
+			phong = m_pSpecularPower->EvaluatePowf(angle, material.glossiness);
+			break;
+		case SpecularPowerMode::lookupTable:
+			phong = m_pSpecularPower->EvaluateTable(angle, material.glossiness);
+			break;
+		case SpecularPowerMode::polynomial:
+			phong = m_pSpecularPower->EvaluatePolynomial(angle, material.glossiness);
+			break;
+		}
+		const ColorRGB specular{ specularColour * phong };
+
+		switch (m_ShadingMode)
+		{
+		case ShadingModes::cosineLambert:  
+			finalColour = ColorRGB{ observedArea, observedArea, observedArea }; 
+			break;
+		case ShadingModes::diffuseLambert:
+			finalColour = lightIntensity * lambertDiffuse * observedArea; 
+			break;
+		case ShadingModes::specularPhong:  
+			finalColour = specular * observedArea; 
+			break;
+		case ShadingModes::combined: 
+			finalColour = ((lambertDiffuse * lightIntensity) + specular + ambient) * observedArea; 
+			break;
+		}
+
+		return finalColour;
+	}
+
+	void Renderer::PixelShadingAVX2(FragmentBatch& batch, float (&colours)[3][m_ShadingLanes]) const
+	{
+		//gathers stay scalar, one material fetch per lane that is in use
+		const SamplerDesc sampler{ GetSoftwareSampler() };
+		for (int lane{ 0 }; lane < m_ShadingLanes; ++lane)
+		{
+			if (lane >= batch.count)
+			{
+				//unused lanes shade a harmless fragment and are never written
+				batch.normal[0][lane] = 0.f;
+				batch.normal[1][lane] = 0.f;
+				batch.normal[2][lane] = 1.f;
+				batch.sampledNormal[0][lane] = 0.f;
+				batch.sampledNormal[1][lane] = 0.f;
+				batch.sampledNormal[2][lane] = 1.f;
+				batch.viewDirection[0][lane] = 0.f;
+				batch.viewDirection[1][lane] = 0.f;
+				batch.viewDirection[2][lane] = 1.f;
+				for (int element{ 0 }; element < 9; ++element)
+				{
+					batch.normalMatrix[element][lane] = element % 4 == 0 ? 1.f : 0.f;
+				}
+				batch.diffuse[0][lane] = 0.f;
+				batch.diffuse[1][lane] = 0.f;
+				batch.diffuse[2][lane] = 0.f;
+				batch.specular[lane] = 0.f;
+				batch.glossiness[lane] = 0.f;
+				continue;
+			}
+
+			const MaterialTexture::MaterialSample material{ m_pVehicleMaterial->Sample(Vector2{ batch.u[lane], batch.v[lane] },
+				Vector2{ batch.uvDdx[0][lane], batch.uvDdx[1][lane] }, Vector2{ batch.uvDdy[0][lane], batch.uvDdy[1][lane] }, sampler) };
+
+			batch.diffuse[0][lane] = material.diffuse.r;
+			batch.diffuse[1][lane] = material.diffuse.g;
+			batch.diffuse[2][lane] = material.diffuse.b;
+			batch.specular[lane] = material.specular;
+			batch.glossiness[lane] = material.glossiness;
+			batch.sampledNormal[0][lane] = material.normal.x;
+			batch.sampledNormal[1][lane] = material.normal.y;
+			batch.sampledNormal[2][lane] = material.normal.z;
+		}
+
+		const __m256 zero{ _mm256_setzero_ps() };
+		const __m256 nx{ _mm256_loadu_ps(batch.normal[0]) };
+		const __m256 ny{ _mm256_loadu_ps(batch.normal[1]) };
+		const __m256 nz{ _mm256_loadu_ps(batch.normal[2]) };
+
+		//object space to world space, one matrix per lane
+		const auto matrixElement = [&](int element)
+			{
+				return _mm256_loadu_ps(batch.normalMatrix[element]);
+			};
+
+		const __m256 mx{ _mm256_loadu_ps(batch.sampledNormal[0]) };
+		const __m256 my{ _mm256_loadu_ps(batch.sampledNormal[1]) };
+		const __m256 mz{ _mm256_loadu_ps(batch.sampledNormal[2]) };
+		__m256 sx{ _mm256_fmadd_ps(matrixElement(6), mz, _mm256_fmadd_ps(matrixElement(3), my, _mm256_mul_ps(matrixElement(0), mx))) };
+		__m256 sy{ _mm256_fmadd_ps(matrixElement(7), mz, _mm256_fmadd_ps(matrixElement(4), my, _mm256_mul_ps(matrixElement(1), mx))) };
+		__m256 sz{ _mm256_fmadd_ps(matrixElement(8), mz, _mm256_fmadd_ps(matrixElement(5), my, _mm256_mul_ps(matrixElement(2), mx))) };
+
+		//rsqrt refined by one Newton-Raphson step, relative error about 5e-7 against 1 / sqrt
+		const __m256 squaredLength{ _mm256_fmadd_ps(sz, sz, _mm256_fmadd_ps(sy, sy, _mm256_mul_ps(sx, sx))) };
+		const __m256 estimate{ _mm256_rsqrt_ps(squaredLength) };
+		const __m256 inverseLength{ _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), estimate),
+			_mm256_fnmadd_ps(_mm256_mul_ps(squaredLength, estimate), estimate, _mm256_set1_ps(3.f))) };
+		sx = _mm256_mul_ps(sx, inverseLength);
+		sy = _mm256_mul_ps(sy, inverseLength);
+		sz = _mm256_mul_ps(sz, inverseLength);
+
+		const __m256 lx{ _mm256_set1_ps(m_LightDirection[0]) };
+		const __m256 ly{ _mm256_set1_ps(m_LightDirection[1]) };
+		const __m256 lz{ _mm256_set1_ps(m_LightDirection[2]) };
+
+		//observed area against the light, which points away from the light
+		const __m256 sampledDotLight{ _mm256_fmadd_ps(sz, lz, _mm256_fmadd_ps(sy, ly, _mm256_mul_ps(sx, lx))) };
+		const __m256 normalDotLight{ _mm256_fmadd_ps(nz, lz, _mm256_fmadd_ps(ny, ly, _mm256_mul_ps(nx, lx))) };
+		const __m256 observedArea{ _mm256_sub_ps(zero, m_IsNormalMapOn ? sampledDotLight : normalDotLight) };
+		const __m256 isLit{ _mm256_cmp_ps(observedArea, zero, _CMP_GT_OQ) };
+
+		//phong reflection, always around the sampled normal like the scalar path
+		const __m256 twiceDot{ _mm256_add_ps(sampledDotLight, sampledDotLight) };
+		const __m256 rx{ _mm256_fnmadd_ps(twiceDot, sx, lx) };
+		const __m256 ry{ _mm256_fnmadd_ps(twiceDot, sy, ly) };
+		const __m256 rz{ _mm256_fnmadd_ps(twiceDot, sz, lz) };
+		const __m256 reflectDotView{ _mm256_fmadd_ps(rz, _mm256_loadu_ps(batch.viewDirection[2]),
+			_mm256_fmadd_ps(ry, _mm256_loadu_ps(batch.viewDirection[1]), _mm256_mul_ps(rx, _mm256_loadu_ps(batch.viewDirection[0])))) };
+		const __m256 angle{ _mm256_max_ps(zero, _mm256_sub_ps(zero, reflectDotView)) };
+
+		//pow(angle, glossiness * shininess)
+		const __m256 glossiness{ _mm256_loadu_ps(batch.glossiness) };
+		__m256 phong{};
+		switch (m_SpecularPowerMode)
+		{
+		case SpecularPowerMode::powf:
+		{
+			float angles[m_ShadingLanes]{};
+			float phongs[m_ShadingLanes]{};
+			_mm256_storeu_ps(angles, angle);
+			for (int lane{ 0 }; lane < m_ShadingLanes; ++lane)
+			{
+				phongs[lane] = m_pSpecularPower->EvaluatePowf(angles[lane], batch.glossiness[lane]);
+			}
+			phong = _mm256_loadu_ps(phongs);
+			break;
+		}
+		case SpecularPowerMode::lookupTable:
+			phong = m_pSpecularPower->EvaluateTableAVX2(angle, glossiness);
+			break;
+		case SpecularPowerMode::polynomial:
+			phong = m_pSpecularPower->EvaluatePolynomialAVX2(angle, glossiness);
+			break;
+		}
+		const __m256 specular{ _mm256_mul_ps(_mm256_loadu_ps(batch.specular), phong) };
+
+		const __m256 lambertScale{ _mm256_set1_ps(m_DiffuseCoefficient / float(M_PI)) };
+		const __m256 intensity{ _mm256_set1_ps(m_LightIntensity) };
+		const __m256 ambient{ _mm256_set1_ps(m_Ambient) };
+
+		for (int channel{ 0 }; channel < 3; ++channel)
+		{
+			const __m256 lambertDiffuse{ _mm256_mul_ps(_mm256_loadu_ps(batch.diffuse[channel]), lambertScale) };
+
+			__m256 colour{};
+			switch (m_ShadingMode)
+			{
+			case ShadingModes::cosineLambert:
+				colour = observedArea;
+				break;
+			case ShadingModes::diffuseLambert:
+				colour = _mm256_mul_ps(_mm256_mul_ps(intensity, lambertDiffuse), observedArea);
+				break;
+			case ShadingModes::specularPhong:
+				colour = _mm256_mul_ps(specular, observedArea);
+				break;
+			case ShadingModes::combined:
+				colour = _mm256_mul_ps(_mm256_add_ps(_mm256_fmadd_ps(lambertDiffuse, intensity, specular), ambient), observedArea);
+				break;
+			}
+
+			//fragments facing away from the light stay black
+			_mm256_storeu_ps(colours[channel], _mm256_and_ps(colour, isLit));
+		}
+	}
+
+	SamplerDesc Renderer::GetSoftwareSampler() const
+	{
+		//same filters as the hardware sampler states in Effect
+		switch (m_Samples)
+		{
+		case SamplerStates::linear:
+			return SamplerDesc{ true, 1 };
+		case SamplerStates::anisotropic:
+			return SamplerDesc{ true, MipChain::m_MaxAnisotropy };
+		default:
+			return SamplerDesc{ false, 1 };
+		}
+	}
+
+	// -----------------------------
+	//		PRINTING INFO PART
+	// -----------------------------
+	void Renderer::PrintTriangleStats() const
+	{
+		if (m_RasterizerSettings == RasterizerSettings::software)
+		{
+			const uint32_t amountOfTriangles{ m_TriangleStats.accepted + m_TriangleStats.clipped + m_TriangleStats.culled };
+			const float culledPercentage{ amountOfTriangles > 0 ? (100.f * m_TriangleStats.culled) / amountOfTriangles : 0.f };
+			const float rasterizedPercentage{ amountOfTriangles > 0 ? (100.f * m_TriangleStats.rasterized) / amountOfTriangles : 0.f };
+
+			std::cout << "Clipping: " << m_TriangleStats.accepted << " accepted, " << m_TriangleStats.clipped << " clipped, "
+					  << m_TriangleStats.culled << " culled (" << culledPercentage << "% never reached setup)" << std::endl;
+			std::cout << "Setup: " << m_TriangleStats.faceCulled << " face culled, " << m_TriangleStats.degenerate << " degenerate, "
+					  << m_TriangleStats.rasterized << " rasterized (" << rasterizedPercentage << "% reached the raster loop)" << std::endl;
+		}
+	}
+
+	void Renderer::OptimizeMeshIndices(const std::string& fileName, std::vector<Vertex_PosCol>& vertices, std::vector<uint32_t>& indices) const
+	{
+		const size_t amountOfTriangles{ indices.size() / 3 };
+		const size_t missesBefore{ Utils::SimulateVertexCacheMisses(indices, vertices.size()) };
+
+		//triangle order for the post-transform cache first, then the vertex order follows the new triangle order
+		Utils::OptimizeVertexCache(indices, vertices.size());
+		Utils::OptimizeVertexFetch(vertices, indices);
+
+		const size_t missesAfter{ Utils::SimulateVertexCacheMisses(indices, vertices.size()) };
+
+		std::cout << fileName << ": " << vertices.size() << " vertices, " << amountOfTriangles << " triangles, "
+				  << "ACMR " << float(missesBefore) / amountOfTriangles << " -> " << float(missesAfter) / amountOfTriangles << ", "
+				  << "ATVR " << float(missesBefore) / vertices.size() << " -> " << float(missesAfter) / vertices.size() << " (16 entry FIFO)" << std::endl;
+	}
+
+	void Renderer::LoadVehicleGeometry(std::vector<Vertex_PosCol>& vertices, std::vector<uint32_t>& indices) const
+	{
+		Utils::ParseOBJ(m_VehicleMeshPath, vertices, indices);
+		OptimizeMeshIndices(m_VehicleMeshPath, vertices, indices);
+		assert(indices.size() / 3 <= m_MaxVisibilityTriangles);
+	}
+
+	void Renderer::PrintMemoryReport() const
+	{
+		//bytes held on either side, per asset and summed per residency class
+		constexpr int amountOfResidencies{ 3 };
+		size_t cpuBytesPerResidency[amountOfResidencies]{};
+		size_t gpuBytesPerResidency[amountOfResidencies]{};
+		constexpr float bytesToKiB{ 1.f / 1024.f };
+
+		const auto printAsset = [&](const std::string& name, Residency residency, size_t cpuBytes, size_t gpuBytes)
+			{
+				cpuBytesPerResidency[static_cast<int>(residency)] += cpuBytes;
+				gpuBytesPerResidency[static_cast<int>(residency)] += gpuBytes;
+
+				std::cout << "\t " << name << " (" << GetResidencyName(residency) << "): "
+						  << cpuBytes * bytesToKiB << " KiB CPU, " << gpuBytes * bytesToKiB << " KiB GPU" << std::endl;
+			};
+
+		std::cout << "[MEMORY]" << std::endl;
+
+		for (const Texture* pTexture : { m_pDiffuseTexture, m_pSpecularTexture, m_pGlossinessTexture, m_pNormalTexture, m_pFireTexture })
+		{
+			printAsset(pTexture->GetPath(), pTexture->GetResidency(), pTexture->GetCpuBytes(), pTexture->GetGpuBytes());
+		}
+
+		if (m_pVehicleMaterial != nullptr)
+		{
+			printAsset("vehicle material", Residency::cpuOnly, m_pVehicleMaterial->GetCpuBytes(), 0);
+		}
+
+		const char* meshPaths[]{ m_VehicleMeshPath, m_FireMeshPath };
+		for (size_t meshIdx{ 0 }; meshIdx < m_pMeshObjects.size(); ++meshIdx)
+		{
+			const Mesh* pMesh{ m_pMeshObjects[meshIdx] };
+			printAsset(meshPaths[meshIdx], pMesh->GetResidency(), pMesh->GetCpuBytes(), pMesh->GetGpuBytes());
+		}
+
+		//transformed vertices, normal matrices, triangle setups and tile bins
+		printAsset("software frame arena", Residency::cpuOnly, m_pFrameArena->GetCapacity(), 0);
+
+		for (int residencyIdx{ 0 }; residencyIdx < amountOfResidencies; ++residencyIdx)
+		{
+			std::cout << "\t Total " << GetResidencyName(static_cast<Residency>(residencyIdx)) << ": "
+					  << cpuBytesPerResidency[residencyIdx] * bytesToKiB << " KiB CPU, " << gpuBytesPerResidency[residencyIdx] * bytesToKiB << " KiB GPU" << std::endl;
+		}
+	}
+
+	void Renderer::PrintingInfo() const
+	{
+		std::cout << "" << std::endl;
+		
+		std::cout << RED_COLOR_TEXT << "[KEY BINDINGS - SHARED]" << std::endl;  
+		std::cout << "\t [F1] Toggle Rasterizing Settings (HARDWARE/SOFTWARE)" << std::endl; 
+		std::cout << "\t [F4] Cycle Sampler State (POINT/LINEAR/ANISOTROPIC)" << std::endl;
+		std::cout << "\t [F5] Toggle Rotation (ON/OFF)" << std::endl; 
+		std::cout << "\t [F6] Toggle Normal Map (ON/OFF)" << std::endl; 
+		std::cout << "\t [F11] Print Memory Report" << RESET_COLOR_TEXT << std::endl << std::endl; 
+
+		std::cout << BLUE_COLOR_TEXT << "[KEY BINDINGS - HARDWARE]" << std::endl; 
+		std::cout << "\t [F7] Toggle FireFX (ON/OFF)" << RESET_COLOR_TEXT << std::endl << std::endl; 
+
+		std::cout << GREEN_COLOR_TEXT << "[KEY BINDINGS - SOFTWARE]" << std::endl;
+		std::cout << "\t [F2] Cycle Shading Modes (COMBINED/OBSERVED AREA/DIFFUSE/SPECULAR)" << std::endl;
+		std::cout << "\t [F3] Cycle Render Modes (FINAL COLOUR/FINAL COLOUR SRGB/DEPTH BUFFER)" << std::endl;
+		std::cout << "\t [F8] Toggle Rasterizing and Shading Kernel (AVX-512/AVX2/SCALAR REFERENCE, from the fastest the CPU runs)" << std::endl;
+		std::cout << "\t [F9] Toggle Shading Pipeline (FORWARD/VISIBILITY BUFFER)" << std::endl;
+		std::cout << "\t [F10] Cycle Cull Modes (BACK/FRONT/NONE)" << std::endl;
+		std::cout << "\t [F12] Cycle Specular Power (LOOKUP TABLE/POLYNOMIAL/POWF)" << RESET_COLOR_TEXT << std::endl << std::endl; 
+	}
 }	
\ No newline at end of file
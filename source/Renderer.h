@@ -1,133 +1,447 @@
-#pragma once
-
-struct SDL_Window;
-struct SDL_Surface;
-
-namespace dae
-{
-	struct Vertex_Out;
-
-	class Mesh;
-	class Camera;
-	class Texture;
-	class EffectVehicle;
-	class EffectFire;
-
-	class Renderer final
-	{
-	public:
-		// CONSTRUCTOR AND DESTRUCTOR
-		Renderer(SDL_Window* pWindow);
-		~Renderer();
-
-		// RULE OF FIVE
-		Renderer(const Renderer& other) = delete;
-		Renderer& operator=(const Renderer& other) = delete;
-		Renderer(Renderer&& other) noexcept = delete;
-		Renderer& operator=(Renderer&& other) noexcept = delete;
-
-		// ENUMS
-		enum class RasterizerSettings
-		{
-			software,
-			hardware
-		};
-
-		enum class RenderMode
-		{
-			finalColour,
-			depthBuffer 
-		};
-
-		enum class SamplerStates
-		{
-			point,
-			linear,
-			anisotropic
-		};
-
-		enum class ShadingModes
-		{
-			cosineLambert,
-			diffuseLambert,
-			specularPhong,
-			combined
-		};
-
-		// MEMBER FUNCTIONS
-		void Update(const Timer* pTimer);
-		void Render() const;
-		void ToggleSamplerState();
-		void ToggleShadingModes();
-		void ToggleRotation();
-		void ToggleNormalMap();
-		void ToggleFireMesh();
-		void ToggleRenderingSettings();
-		void ToggleRenderModes();
-
-	private:
-		// SHARED VARIABLES
-		SDL_Window* m_pWindow{};
-
-		Texture* m_pDiffuseTexture; 
-		Texture* m_pSpecularTexture; 
-		Texture* m_pGlossinessTexture; 
-		Texture* m_pNormalTexture; 
-
-		SamplerStates m_Samples{ SamplerStates::point }; 
-		ShadingModes m_ShadingMode{ ShadingModes::combined };
-		RasterizerSettings m_RasterizerSettings{ RasterizerSettings::hardware };
-
-		bool m_IsRotating{ false };
-		bool m_IsNormalMapOn{ true };
-
-		// HARDWARE VARIABLES
-		int m_Width{};
-		int m_Height{};
-
-		bool m_IsInitialized{ false };
-		bool m_IsShowingFireMesh{ true };
-
-		ID3D11Device* m_pDevice;
-		ID3D11DeviceContext* m_pDeviceContext;
-		IDXGISwapChain* m_pSwapChain;
-		ID3D11Texture2D* m_pDepthStencilBuffer;
-		ID3D11DepthStencilView* m_pDepthStencilView;
-		ID3D11Resource* m_pRenderTargetBuffer;
-		ID3D11RenderTargetView* m_pRenderTargetView;
-
-		std::vector<Mesh*> m_pMeshObjects;
-		Camera* m_pCamera;
-
-		EffectVehicle* m_pEffectVehicle;
-		EffectFire* m_pEffectFire;
-
-		Texture* m_pFireTexture;
-
-		// SOFTWARE VARIABLES
-		RenderMode m_RenderMode{ RenderMode::finalColour };
-
-		SDL_Surface* m_pFrontBuffer{ nullptr };
-		SDL_Surface* m_pBackBuffer{ nullptr };
-		uint32_t* m_pBackBufferPixels{};
-
-		float* m_pDepthBufferPixels{};
-
-		// DIRECTX FUNCTIONS
-		void Render_Hardware() const;
-
-		HRESULT InitializeDirectX();
-
-		// SOFTWARE FUNCTIONS
-		void Render_Software() const;
-		void VertexTransformationFunction(const std::vector<Mesh*>& meshes_in) const;
-		void TriangleHandeling(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, Mesh* mesh_transformed) const;
-		void ProcessRenderedTriangle(const Vertex_Out v0, const Vertex_Out v1, const Vertex_Out v2, float w0, float w1, float w2, int px, int py) const;
-
-		float Remap(float value, float inputMin, float inputMax) const;
-		ColorRGB PixelShading(const Vertex_Out& v) const;
-
-		// MEMBER FUCTIONS
-		void PrintingInfo() const;
-	};
-}
+#pragma once
+
+struct SDL_Window;
+struct SDL_Surface;
+
+namespace dae
+{
+	struct Vertex_Out;
+	struct Vertex_PosCol;
+	struct VertexStreams;
+	struct SamplerDesc;
+
+	enum class InstructionSet;
+
+	class Mesh;
+	class Camera;
+	class Texture;
+	class MaterialTexture;
+	class SpecularPower;
+	class FrameArena;
+	class EffectVehicle;
+	class EffectFire;
+
+	class Renderer final
+	{
+	public:
+		// CONSTRUCTOR AND DESTRUCTOR
+		//the software kernels run on the highest instruction set the CPU supports, capped at instructionSetLimit
+		Renderer(SDL_Window* pWindow, InstructionSet instructionSetLimit);
+		~Renderer();
+
+		// RULE OF FIVE
+		Renderer(const Renderer& other) = delete;
+		Renderer& operator=(const Renderer& other) = delete;
+		Renderer(Renderer&& other) noexcept = delete;
+		Renderer& operator=(Renderer&& other) noexcept = delete;
+
+		// ENUMS
+		enum class RasterizerSettings
+		{
+			software,
+			hardware
+		};
+
+		enum class RenderMode
+		{
+			finalColour,
+			finalColourSRGB,
+			depthBuffer 
+		};
+
+		enum class SamplerStates
+		{
+			point,
+			linear,
+			anisotropic
+		};
+
+		enum class ShadingModes
+		{
+			cosineLambert,
+			diffuseLambert,
+			specularPhong,
+			combined
+		};
+
+		enum class RasterizerKernel
+		{
+			avx512,
+			avx2,
+			scalar
+		};
+
+		enum class ShadingPipeline
+		{
+			forward,
+			visibilityBuffer
+		};
+
+		enum class CullModes
+		{
+			back,
+			front,
+			none
+		};
+
+		enum class SpecularPowerMode
+		{
+			powf,
+			lookupTable,
+			polynomial
+		};
+
+		// MEMBER FUNCTIONS
+		void Update(const Timer* pTimer);
+		void Render() const;
+		void ToggleSamplerState();
+		void ToggleShadingModes();
+		void ToggleRotation();
+		void ToggleNormalMap();
+		void ToggleFireMesh();
+		void ToggleRenderingSettings();
+		void ToggleRenderModes();
+		void ToggleRasterizerKernel();
+		void ToggleShadingPipeline();
+		void ToggleCullModes();
+		void ToggleSpecularPower();
+		void PrintTriangleStats() const;
+		void PrintMemoryReport() const;
+
+	private:
+		// SHARED VARIABLES
+		SDL_Window* m_pWindow{};
+
+		Texture* m_pDiffuseTexture; 
+		Texture* m_pSpecularTexture; 
+		Texture* m_pGlossinessTexture; 
+		Texture* m_pNormalTexture; 
+		MaterialTexture* m_pVehicleMaterial;
+
+		SamplerStates m_Samples{ SamplerStates::point }; 
+		ShadingModes m_ShadingMode{ ShadingModes::combined };
+		RasterizerSettings m_RasterizerSettings{ RasterizerSettings::hardware };
+
+		bool m_IsRotating{ false };
+		bool m_IsNormalMapOn{ true };
+
+		// SHARED STRUCTS
+		//vehicle.obj parsed and optimized like it is uploaded, with the normal rotations of its triangles
+		struct VehicleGeometry;
+
+		//only set while the constructor loads the vehicle, the normal map bake and the mesh share it
+		VehicleGeometry* m_pVehicleGeometry{ nullptr };
+
+		// SHARED CONSTANTS
+		//the meshes are parsed again from these when the software path needs their CPU copy
+		static constexpr const char* m_VehicleMeshPath{ "Resources/vehicle.obj" };
+		static constexpr const char* m_FireMeshPath{ "Resources/fireFX.obj" };
+
+		// HARDWARE VARIABLES
+		int m_Width{};
+		int m_Height{};
+
+		bool m_IsInitialized{ false };
+		bool m_IsShowingFireMesh{ true };
+
+		ID3D11Device* m_pDevice;
+		ID3D11DeviceContext* m_pDeviceContext;
+		IDXGISwapChain* m_pSwapChain;
+		ID3D11Texture2D* m_pDepthStencilBuffer;
+		ID3D11DepthStencilView* m_pDepthStencilView;
+		ID3D11Resource* m_pRenderTargetBuffer;
+		ID3D11RenderTargetView* m_pRenderTargetView;
+
+		std::vector<Mesh*> m_pMeshObjects;
+		Camera* m_pCamera;
+
+		EffectVehicle* m_pEffectVehicle;
+		EffectFire* m_pEffectFire;
+
+		Texture* m_pFireTexture;
+
+		// SOFTWARE CONSTANTS
+		static constexpr int m_TileSize{ 64 };
+
+		//vertices are snapped to 28.4 fixed point before rasterization
+		static constexpr int m_SubPixelBits{ 4 };
+		static constexpr int m_SubPixelScale{ 1 << m_SubPixelBits };
+		static constexpr int m_HalfPixel{ m_SubPixelScale / 2 };
+
+		//hierarchical depth keeps the nearest and farthest depth of every 8x8 block of a tile
+		static constexpr int m_HiZBlockSize{ 8 };
+		static constexpr int m_HiZBlocksPerRow{ m_TileSize / m_HiZBlockSize };
+		static constexpr int m_HiZBlocksPerTile{ m_HiZBlocksPerRow * m_HiZBlocksPerRow };
+		static_assert(m_HiZBlocksPerTile <= 64, "one dirty bit per hierarchical depth block");
+
+		//visibility id: mesh index in the top bits, triangle index in the bottom bits
+		static constexpr int m_VisibilityTriangleBits{ 24 };
+		static constexpr uint32_t m_VisibilityTriangleMask{ (1u << m_VisibilityTriangleBits) - 1 };
+		static constexpr uint32_t m_EmptyVisibilityId{ UINT32_MAX };
+
+		//what fits in a visibility id, the last triangle index of the last mesh would be the empty id
+		static constexpr size_t m_MaxVisibilityMeshes{ size_t(1) << (32 - m_VisibilityTriangleBits) };
+		static constexpr size_t m_MaxVisibilityTriangles{ m_VisibilityTriangleMask };
+
+		//guard band half extent in pixels around the screen centre, keeps 28.4 edge functions inside int32
+		static constexpr float m_GuardBandPixels{ 768.f };
+
+		//a triangle clipped against the near plane and the four guard band planes
+		static constexpr int m_MaxClippedVertices{ 3 + 5 };
+
+		//vertices are transformed 8 at a time, a worker takes a chunk of them
+		static constexpr size_t m_VertexChunkSize{ 1024 };
+
+		//first size of the frame arena, it grows to what a frame needs the first time one does not fit
+		static constexpr size_t m_FrameArenaBytes{ 4 * 1024 * 1024 };
+
+		//pixels are shaded 8 at a time, one per AVX2 lane
+		static constexpr int m_ShadingLanes{ 8 };
+
+		//lighting, shared by the scalar and the AVX2 pixel shader
+		static constexpr float m_LightDirection[3]{ 0.577f, -0.577f, 0.577f };
+		static constexpr float m_LightIntensity{ 7.f };
+		static constexpr float m_DiffuseCoefficient{ 1.f };
+		static constexpr float m_Shininess{ 25.f };
+		static constexpr float m_Ambient{ 0.03f };
+
+		//linear colour in [0, 1] to sRGB encoded bytes, 12 bits of linear precision
+		static constexpr int m_SRGBTableSize{ 4096 };
+
+		// SOFTWARE STRUCTS
+		// Back buffer pixel layout, resolved once from its SDL format so packing a pixel is only shifts
+		struct OutputFormat
+		{
+			int redShift{};
+			int greenShift{};
+			int blueShift{};
+			uint32_t alphaMask{};
+		};
+
+		// a * dx + b * dy + c, with dx and dy measured from the origin of the triangle setup (its first vertex)
+		// so c stays small and precise
+		struct PlaneEquation
+		{
+			float a{};
+			float b{};
+			float c{};
+
+			float Evaluate(float dx, float dy) const
+			{
+				return a * dx + b * dy + c;
+			}
+		};
+
+		// Exact edge function on the sub-pixel grid: a * dx + b * dy + c, dx and dy in fixed point
+		struct EdgeFunction
+		{
+			int a{};
+			int b{};
+			int c{};
+
+			int Evaluate(int dx, int dy) const
+			{
+				return a * dx + b * dy + c;
+			}
+		};
+
+		// Everything the raster loop needs from a triangle, computed once in TriangleSetup
+		struct TriangleSetupRecord
+		{
+			//edge functions, >= 0 on the inside of the triangle, fill rule already applied
+			EdgeFunction edges[3]{};
+
+			//interpolants, already weighted by the normalized barycentric coordinates
+			PlaneEquation z{};
+			PlaneEquation invW{};
+			PlaneEquation uvDivW[2]{};
+			PlaneEquation colourDivW[3]{};
+			PlaneEquation normalDivW[3]{};
+			PlaneEquation viewDirectionDivW[3]{};
+
+			//snapped screen position every plane is relative to, in pixels and in fixed point
+			float originX{};
+			float originY{};
+			int fixedOriginX{};
+			int fixedOriginY{};
+
+			//nearest and farthest depth of the triangle, for hierarchical depth rejection
+			float minZ{};
+			float maxZ{};
+
+			//bounding box in pixels, clamped to screen
+			int minX{};
+			int minY{};
+			int maxX{};
+			int maxY{};
+
+			//packed (mesh, triangle) id written to the visibility buffer
+			uint32_t visibilityId{};
+		};
+
+		// Covered pixels waiting to be shaded, one array of lanes per component. Pixels are collected over quads
+		// and triangles until every SIMD lane is filled
+		struct FragmentBatch
+		{
+			int count{};
+			int bufferIdx[m_ShadingLanes]{};
+			float depth[m_ShadingLanes]{};
+
+			float u[m_ShadingLanes]{};
+			float v[m_ShadingLanes]{};
+			float uvDdx[2][m_ShadingLanes]{};
+			float uvDdy[2][m_ShadingLanes]{};
+			float normal[3][m_ShadingLanes]{};
+			float viewDirection[3][m_ShadingLanes]{};
+			float normalMatrix[9][m_ShadingLanes]{};
+
+			//material samples, fetched right before shading
+			float diffuse[3][m_ShadingLanes]{};
+			float specular[m_ShadingLanes]{};
+			float glossiness[m_ShadingLanes]{};
+			float sampledNormal[3][m_ShadingLanes]{};
+		};
+
+		// Screen region rasterized by one worker, owns its slice of the colour and depth memory
+		struct Tile
+		{
+			int minX{};
+			int minY{};
+			int maxX{};
+			int maxY{};
+
+			uint32_t* pColourPixels{};
+			float* pDepthPixels{};
+			uint32_t* pVisibilityPixels{};
+
+			//hierarchical depth, a block's bounds are recomputed lazily after its depth was written
+			float hiZMin[m_HiZBlocksPerTile]{};
+			float hiZMax[m_HiZBlocksPerTile]{};
+			uint64_t hiZDirtyBlocks{};
+
+			//indices into m_TriangleSetups, in the frame arena
+			std::span<const uint32_t> bin{};
+
+			FragmentBatch fragmentBatch{};
+		};
+
+		// 2x2 pixels shaded together: lanes 0 and 1 are the top row, lanes 2 and 3 the bottom row.
+		// Lanes outside the coverage mask are helper lanes, interpolated for the derivatives but never written
+		struct Quad
+		{
+			int x{};
+			int y{};
+			int coverageMask{};
+			float depth[4]{};
+		};
+
+		// Interpolated vertex attributes of the four lanes of a quad, one array of lanes per component
+		struct QuadVaryings
+		{
+			float u[4]{};
+			float v[4]{};
+			float colour[3][4]{};
+			float normal[3][4]{};
+			float viewDirection[3][4]{};
+
+			//rotates the object space normal map to world space, rows x, y and z, the same for every lane of the quad
+			float normalMatrix[9]{};
+		};
+
+		// Triangles seen by the clipping stage and triangle setup in the last rasterized frame
+		struct TriangleStats
+		{
+			uint32_t accepted{};
+			uint32_t clipped{};
+			uint32_t culled{};
+			uint32_t faceCulled{};
+			uint32_t degenerate{};
+			uint32_t rasterized{};
+		};
+
+		// SOFTWARE VARIABLES
+		RenderMode m_RenderMode{ RenderMode::finalColour };
+		//the fastest kernel the selected instruction set runs, toggling only goes down from it
+		RasterizerKernel m_FastestRasterizerKernel{ RasterizerKernel::scalar };
+		RasterizerKernel m_RasterizerKernel{ RasterizerKernel::scalar };
+		ShadingPipeline m_ShadingPipeline{ ShadingPipeline::forward };
+		CullModes m_CullMode{ CullModes::back };
+		SpecularPowerMode m_SpecularPowerMode{ SpecularPowerMode::lookupTable };
+
+		//shared by the scalar and the AVX2 pixel shader
+		SpecularPower* m_pSpecularPower{ nullptr };
+
+		//transformed vertices, triangle setups and tile bins of the last rasterized frame. A frame that only shades
+		//the visibility buffer again still reads them, so the arena is only reset when the geometry is rasterized again
+		FrameArena* m_pFrameArena{ nullptr };
+
+		SDL_Surface* m_pFrontBuffer{ nullptr };
+		SDL_Surface* m_pBackBuffer{ nullptr };
+		uint32_t* m_pBackBufferPixels{};
+		OutputFormat m_OutputFormat{};
+		std::vector<int> m_SRGBTable{};
+
+		//tile-major: every tile's pixels are one contiguous block of m_TileSize * m_TileSize
+		uint32_t* m_pColourBufferPixels{};
+		float* m_pDepthBufferPixels{};
+		uint32_t* m_pVisibilityBufferPixels{};
+
+		//the visibility buffer is only rasterized again when the geometry or the camera moved
+		mutable bool m_IsVisibilityBufferValid{ false };
+		mutable std::vector<Matrix> m_VisibilityWorldViewProjections{};
+
+		//guard band in clip space, as a multiple of w
+		float m_GuardBandX{};
+		float m_GuardBandY{};
+		mutable TriangleStats m_TriangleStats{};
+
+		int m_AmountOfTilesX{};
+		int m_AmountOfTilesY{};
+		mutable std::vector<Tile> m_Tiles{};
+		mutable std::span<const TriangleSetupRecord> m_TriangleSetups{};
+
+		// DIRECTX FUNCTIONS
+		void Render_Hardware() const;
+
+		HRESULT InitializeDirectX();
+
+		// SOFTWARE FUNCTIONS
+		void MakeSoftwareResident();
+		void Render_Software() const;
+		void VertexTransformationFunction(const std::vector<Mesh*>& meshes_in) const;
+		void TransformVertices(const VertexStreams& streams, size_t begin, size_t end, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, Vertex_Out* pVerticesOut) const;
+		void TransformVerticesAVX2(const VertexStreams& streams, size_t begin, size_t end, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, Vertex_Out* pVerticesOut) const;
+		void TransformVerticesAVX512(const VertexStreams& streams, size_t begin, size_t end, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, Vertex_Out* pVerticesOut) const;
+		void BinTriangles() const;
+		int ClipTriangle(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, Vertex_Out* pClippedVertices) const;
+		void ProjectToScreen(Vertex_Out& vertex) const;
+		bool TriangleSetup(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, TriangleSetupRecord& setup) const;
+		void RenderTile(Tile& tile, uint32_t clearColour) const;
+		void ResolveTile(const Tile& tile) const;
+		void TriangleHandeling(const TriangleSetupRecord& setup, Tile& tile) const;
+		void TriangleHandelingAVX2(const TriangleSetupRecord& setup, Tile& tile) const;
+		void TriangleHandelingAVX512(const TriangleSetupRecord& setup, Tile& tile) const;
+		void UpdateHiZBlock(Tile& tile, int hiZIdx) const;
+		bool ProcessRenderedTriangle(const TriangleSetupRecord& setup, float zBufferValue, int px, int py, Tile& tile) const;
+		void InterpolateQuad(const TriangleSetupRecord& setup, int quadX, int quadY, QuadVaryings& varyings) const;
+		bool IsVisibilityBufferCurrent() const;
+		void ShadeVisibilityTile(Tile& tile, uint32_t clearColour) const;
+		void InterpolateVisibleQuad(uint32_t visibilityId, int quadX, int quadY, QuadVaryings& varyings) const;
+		void GetNormalMatrix(uint32_t visibilityId, float (&normalMatrix)[9]) const;
+		void ShadeQuad(const Quad& quad, QuadVaryings& varyings, Tile& tile) const;
+		void ShadeFragmentBatch(Tile& tile) const;
+		uint32_t PackColour(uint8_t red, uint8_t green, uint8_t blue) const;
+		void PackColours(const float (&colours)[3][m_ShadingLanes], uint32_t (&pixels)[m_ShadingLanes]) const;
+		void PackColoursAVX2(const float (&colours)[3][m_ShadingLanes], uint32_t (&pixels)[m_ShadingLanes]) const;
+
+		float Remap(float value, float inputMin, float inputMax) const;
+		ColorRGB PixelShading(const Vertex_Out& v, const Matrix& normalMatrix, const Vector2& uvDdx, const Vector2& uvDdy) const;
+		void PixelShadingAVX2(FragmentBatch& batch, float (&colours)[3][m_ShadingLanes]) const;
+		SamplerDesc GetSoftwareSampler() const;
+
+		// MEMBER FUCTIONS
+		void PrintingInfo() const;
+		void OptimizeMeshIndices(const std::string& fileName, std::vector<Vertex_PosCol>& vertices, std::vector<uint32_t>& indices) const;
+		void LoadVehicleGeometry(std::vector<Vertex_PosCol>& vertices, std::vector<uint32_t>& indices) const;
+	};
+}
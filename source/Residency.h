@@ -0,0 +1,19 @@
+#pragma once
+
+namespace dae
+{
+	// Where the data of an asset is kept once it is loaded. The GPU copy is made at load time and stays for the lifetime of the asset,
+	// the CPU copy is loaded again from the source asset the first time the software rasterizer needs it and kept from then on
+	enum class Residency
+	{
+		gpuOnly,
+		cpuOnly,
+		both
+	};
+
+	inline const char* GetResidencyName(Residency residency)
+	{
+		constexpr const char* names[]{ "GPU ONLY", "CPU ONLY", "CPU AND GPU" };
+		return names[static_cast<int>(residency)];
+	}
+}
@@ -8,6 +8,7 @@ Texture2D gDiffuseMap : DiffuseMap;
 Texture2D gSpecularMap : SpecularMap;
 Texture2D gGlossinessMap : GlossinessMap;
 Texture2D gNormalMap : NormalMap;
+Buffer<float4> gNormalRotations : NormalRotations;
 
 SamplerState gSamplerState : Sample;
 RasterizerState gRasterizerState : RASTERIZERSTAGE;
@@ -40,7 +41,6 @@ struct VS_INPUT
     float3 Position      : POSITION;
     float2 UV            : TEXCOORD;
     float3 Normal        : NORMAL;
-    float3 Tangent       : TANGENT;
 };
 
 struct VS_OUTPUT
@@ -49,7 +49,6 @@ struct VS_OUTPUT
     float4 WorldPosition : TEXCOORD;
     float2 UV            : TEXCOORD1;
     float3 Normal        : NORMAL;
-    float3 Tangent       : TANGENT;
 };
 
 //--------------------------------------------
@@ -62,7 +61,6 @@ VS_OUTPUT VS(VS_INPUT input)
     output.WorldPosition = mul(float4(input.Position, 1.f), gWorldMatrix);
     output.UV = input.UV;
     output.Normal = mul(normalize(input.Normal), (float3x3) gWorldMatrix);
-    output.Tangent = mul(normalize(input.Tangent), (float3x3) gWorldMatrix);
 	return output;
 }
 
@@ -78,6 +76,21 @@ float3 LambertShading(float kd, float3 cd)
     return lambertDiffuse;
 }
 
+//--------------------------------------------
+//   Octahedral Normal
+//--------------------------------------------
+float3 DecodeOctahedral(float2 encoded)
+{
+    //change range [0, 1] to [-1, 1], the lower hemisphere is folded over the diagonals of the square
+    float3 normal = float3(2.f * encoded - float2(1.f, 1.f), 0.f);
+    normal.z = 1.f - abs(normal.x) - abs(normal.y);
+    
+    const float fold = saturate(-normal.z);
+    normal.xy += (normal.xy >= 0.f) ? -fold : fold;
+    
+    return normal;
+}
+
 //--------------------------------------------
 //   Phong Reflection
 //--------------------------------------------
@@ -93,7 +106,7 @@ float3 PhongReflection(float ks, float exponent, float3 lightVector, float3 view
 //--------------------------------------------
 //   Pixel Shader
 //--------------------------------------------
-float4 PS(VS_OUTPUT input) : SV_TARGET
+float4 PS(VS_OUTPUT input, uint primitiveId : SV_PrimitiveID) : SV_TARGET
 {
     //variables
     const float3 invViewDirection = normalize(gCameraPosition - input.WorldPosition.xyz);
@@ -106,14 +119,10 @@ float4 PS(VS_OUTPUT input) : SV_TARGET
     
     if (gUseNormals)
     {
-         //create tangent space transformation matrix
-        const float3 binormal = cross(input.Normal, input.Tangent);
-        const float3x3 tangentSpaceAxis = float3x3(input.Tangent, binormal, input.Normal);
-    
-        //sample from normal map and multiply it with matrix
-        //change range [0, 1] to [-1, 1]
-        const float3 normalMap = 2.f * normalSample.rgb - float3(1.f, 1.f, 1.f);
-        const float3 sampledNormal = normalize(mul(normalMap, tangentSpaceAxis));
+        //the normal map is baked to object space, triangles sharing their texels with another part rotate it to their own first
+        const float3x3 normalRotation = float3x3(gNormalRotations.Load(primitiveId * 3).xyz, gNormalRotations.Load(primitiveId * 3 + 1).xyz, gNormalRotations.Load(primitiveId * 3 + 2).xyz);
+        const float3 normalMap = mul(DecodeOctahedral(normalSample.rg), normalRotation);
+        const float3 sampledNormal = normalize(mul(normalMap, (float3x3) gWorldMatrix));
     
         observedArea = dot(sampledNormal, normalize(gLightDirection) * -1.f);
     }
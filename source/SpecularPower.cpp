@@ -0,0 +1,265 @@
+#include "pch.h"
+#include "SpecularPower.h"
+#include "Texture.h"
+#include "CpuFeatures.h"
+
+using namespace dae;
+
+//8-wide log2 of positive values: the exponent bits plus the series of ln(m) in t = (m - 1) / (m + 1),
+//with the mantissa m moved into [sqrt(0.5), sqrt(2)] so t stays below 0.172. Absolute error about 1e-7, log2(0) is -FLT_MAX
+//so pow(0, exponent) keeps going to 0 for tiny exponents
+static __m256 Log2AVX2(__m256 value)
+{
+	const __m256 one{ _mm256_set1_ps(1.f) };
+	const __m256i bits{ _mm256_castps_si256(value) };
+
+	__m256i exponent{ _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)) };
+	__m256 mantissa{ _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x7FFFFF)), _mm256_castps_si256(one))) };
+
+	const __m256 isLarge{ _mm256_cmp_ps(mantissa, _mm256_set1_ps(1.41421356f), _CMP_GT_OQ) };
+	mantissa = _mm256_blendv_ps(mantissa, _mm256_mul_ps(mantissa, _mm256_set1_ps(0.5f)), isLarge);
+	exponent = _mm256_sub_epi32(exponent, _mm256_castps_si256(isLarge));
+
+	//ln(m) = 2 * (t + t^3 / 3 + t^5 / 5 + t^7 / 7 + ...)
+	const __m256 t{ _mm256_div_ps(_mm256_sub_ps(mantissa, one), _mm256_add_ps(mantissa, one)) };
+	const __m256 tSquared{ _mm256_mul_ps(t, t) };
+
+	__m256 series{ _mm256_fmadd_ps(tSquared, _mm256_set1_ps(1.f / 7.f), _mm256_set1_ps(1.f / 5.f)) };
+	series = _mm256_fmadd_ps(tSquared, series, _mm256_set1_ps(1.f / 3.f));
+	series = _mm256_fmadd_ps(tSquared, series, one);
+
+	const __m256 result{ _mm256_fmadd_ps(_mm256_mul_ps(t, series), _mm256_set1_ps(2.f / 0.693147181f), _mm256_cvtepi32_ps(exponent)) };
+	return _mm256_blendv_ps(result, _mm256_set1_ps(-FLT_MAX), _mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_LE_OQ));
+}
+
+//8-wide 2^value: the nearest integer goes straight into the exponent bits, the remaining [-0.5, 0.5] into a
+//degree 6 Taylor polynomial. Relative error about 2e-7, results below 2^-126 flush to 2^-126
+static __m256 Exp2AVX2(__m256 value)
+{
+	value = _mm256_min_ps(_mm256_max_ps(value, _mm256_set1_ps(-126.f)), _mm256_set1_ps(127.f));
+
+	const __m256 integer{ _mm256_round_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) };
+	const __m256 fraction{ _mm256_sub_ps(value, integer) };
+
+	__m256 polynomial{ _mm256_fmadd_ps(fraction, _mm256_set1_ps(1.54035304e-4f), _mm256_set1_ps(1.33335581e-3f)) };
+	polynomial = _mm256_fmadd_ps(fraction, polynomial, _mm256_set1_ps(9.61812911e-3f));
+	polynomial = _mm256_fmadd_ps(fraction, polynomial, _mm256_set1_ps(5.55041087e-2f));
+	polynomial = _mm256_fmadd_ps(fraction, polynomial, _mm256_set1_ps(2.40226507e-1f));
+	polynomial = _mm256_fmadd_ps(fraction, polynomial, _mm256_set1_ps(6.93147181e-1f));
+	polynomial = _mm256_fmadd_ps(fraction, polynomial, _mm256_set1_ps(1.f));
+
+	const __m256i scale{ _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(integer), _mm256_set1_epi32(127)), 23) };
+	return _mm256_mul_ps(polynomial, _mm256_castsi256_ps(scale));
+}
+
+//scalar log2 with the same range reduction and series as Log2AVX2, for CPUs without AVX2
+static float Log2(float value)
+{
+	if (value <= 0.f)
+	{
+		return -FLT_MAX;
+	}
+
+	const uint32_t bits{ std::bit_cast<uint32_t>(value) };
+	int exponent{ static_cast<int>(bits >> 23) - 127 };
+	float mantissa{ std::bit_cast<float>((bits & 0x7FFFFF) | 0x3F800000) };
+
+	if (mantissa > 1.41421356f)
+	{
+		mantissa *= 0.5f;
+		++exponent;
+	}
+
+	const float t{ (mantissa - 1.f) / (mantissa + 1.f) };
+	const float tSquared{ t * t };
+
+	float series{ (tSquared * (1.f / 7.f)) + (1.f / 5.f) };
+	series = (tSquared * series) + (1.f / 3.f);
+	series = (tSquared * series) + 1.f;
+
+	return (t * series * (2.f / 0.693147181f)) + float(exponent);
+}
+
+//scalar 2^value with the same coefficients as Exp2AVX2
+static float Exp2(float value)
+{
+	value = std::min(std::max(value, -126.f), 127.f);
+
+	const float integer{ std::nearbyint(value) };
+	const float fraction{ value - integer };
+
+	float polynomial{ (fraction * 1.54035304e-4f) + 1.33335581e-3f };
+	polynomial = (fraction * polynomial) + 9.61812911e-3f;
+	polynomial = (fraction * polynomial) + 5.55041087e-2f;
+	polynomial = (fraction * polynomial) + 2.40226507e-1f;
+	polynomial = (fraction * polynomial) + 6.93147181e-1f;
+	polynomial = (fraction * polynomial) + 1.f;
+
+	return polynomial * std::bit_cast<float>(static_cast<uint32_t>(static_cast<int>(integer) + 127) << 23);
+}
+
+SpecularPower::SpecularPower(float shininess) :
+	m_Shininess{ shininess }
+{
+	m_Table.resize(size_t(m_GlossinessSteps) * (m_AngleSteps + 1));
+
+	for (int glossinessStep{ 0 }; glossinessStep < m_GlossinessSteps; ++glossinessStep)
+	{
+		const float exponent{ glossinessStep / float(m_GlossinessSteps - 1) * m_Shininess };
+		float* pRow{ m_Table.data() + (size_t(glossinessStep) * (m_AngleSteps + 1)) };
+
+		for (int angleStep{ 0 }; angleStep <= m_AngleSteps; ++angleStep)
+		{
+			pRow[angleStep] = std::powf(angleStep / float(m_AngleSteps), exponent);
+		}
+	}
+}
+
+float SpecularPower::EvaluatePowf(float angle, float glossiness) const
+{
+	return std::powf(angle, glossiness * m_Shininess);
+}
+
+float SpecularPower::EvaluateTable(float angle, float glossiness) const
+{
+	const float rowPosition{ std::clamp(glossiness, 0.f, 1.f) * (m_GlossinessSteps - 1) };
+	const int glossinessStep{ std::min(static_cast<int>(rowPosition), m_GlossinessSteps - 2) };
+	const float rowWeight{ rowPosition - glossinessStep };
+
+	const float position{ std::clamp(angle, 0.f, 1.f) * m_AngleSteps };
+	const int angleStep{ std::min(static_cast<int>(position), m_AngleSteps - 1) };
+	const float weight{ position - angleStep };
+
+	const float* pValues0{ m_Table.data() + (size_t(glossinessStep) * (m_AngleSteps + 1)) + angleStep };
+	const float* pValues1{ pValues0 + (m_AngleSteps + 1) };
+	const float value0{ pValues0[0] + ((pValues0[1] - pValues0[0]) * weight) };
+	const float value1{ pValues1[0] + ((pValues1[1] - pValues1[0]) * weight) };
+	return value0 + ((value1 - value0) * rowWeight);
+}
+
+float SpecularPower::EvaluatePolynomial(float angle, float glossiness) const
+{
+	return Exp2(glossiness * m_Shininess * Log2(angle));
+}
+
+__m256 SpecularPower::EvaluateTableAVX2(__m256 angle, __m256 glossiness) const
+{
+	//blends the two nearest rows like the scalar version
+	const __m256 rowPosition{ _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(glossiness, _mm256_setzero_ps()), _mm256_set1_ps(1.f)), _mm256_set1_ps(float(m_GlossinessSteps - 1))) };
+	const __m256i glossinessStep{ _mm256_min_epi32(_mm256_cvttps_epi32(rowPosition), _mm256_set1_epi32(m_GlossinessSteps - 2)) };
+	const __m256 rowWeight{ _mm256_sub_ps(rowPosition, _mm256_cvtepi32_ps(glossinessStep)) };
+
+	const __m256 position{ _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(angle, _mm256_setzero_ps()), _mm256_set1_ps(1.f)), _mm256_set1_ps(float(m_AngleSteps))) };
+	const __m256i angleStep{ _mm256_min_epi32(_mm256_cvttps_epi32(position), _mm256_set1_epi32(m_AngleSteps - 1)) };
+	const __m256 weight{ _mm256_sub_ps(position, _mm256_cvtepi32_ps(angleStep)) };
+
+	const __m256i valueIdx{ _mm256_add_epi32(_mm256_mullo_epi32(glossinessStep, _mm256_set1_epi32(m_AngleSteps + 1)), angleStep) };
+	const float* pRow1{ m_Table.data() + (m_AngleSteps + 1) };
+
+	const __m256 value00{ _mm256_i32gather_ps(m_Table.data(), valueIdx, sizeof(float)) };
+	const __m256 value01{ _mm256_i32gather_ps(m_Table.data() + 1, valueIdx, sizeof(float)) };
+	const __m256 value10{ _mm256_i32gather_ps(pRow1, valueIdx, sizeof(float)) };
+	const __m256 value11{ _mm256_i32gather_ps(pRow1 + 1, valueIdx, sizeof(float)) };
+
+	const __m256 value0{ _mm256_fmadd_ps(_mm256_sub_ps(value01, value00), weight, value00) };
+	const __m256 value1{ _mm256_fmadd_ps(_mm256_sub_ps(value11, value10), weight, value10) };
+	return _mm256_fmadd_ps(_mm256_sub_ps(value1, value0), rowWeight, value0);
+}
+
+__m256 SpecularPower::EvaluatePolynomialAVX2(__m256 angle, __m256 glossiness) const
+{
+	const __m256 exponent{ _mm256_mul_ps(glossiness, _mm256_set1_ps(m_Shininess)) };
+	return Exp2AVX2(_mm256_mul_ps(exponent, Log2AVX2(angle)));
+}
+
+void SpecularPower::PrintAccuracyReport(const Texture* pGlossinessTexture) const
+{
+	//how many texels hold every glossiness value, point sampled at the texel centres of the first level
+	std::vector<uint32_t> histogram(m_GlossinessSteps);
+	const int width{ pGlossinessTexture->GetWidth() };
+	const int height{ pGlossinessTexture->GetHeight() };
+
+	for (int y{ 0 }; y < height; ++y)
+	{
+		for (int x{ 0 }; x < width; ++x)
+		{
+			const Vector2 uv{ (x + 0.5f) / width, (y + 0.5f) / height };
+			const float glossiness{ pGlossinessTexture->Sample(uv, Vector2{}, Vector2{}, SamplerDesc{}).r };
+			++histogram[static_cast<int>((glossiness * (m_GlossinessSteps - 1)) + 0.5f)];
+		}
+	}
+
+	//every value the map holds and the values filtering blends between it and the next row, against a sweep of angles.
+	//Errors are weighted by how many texels hold the value, and measured on the evaluators the software shader runs on this CPU
+	const bool isAVX2{ CpuFeatures::GetInstructionSet() != InstructionSet::baseline };
+	constexpr int amountOfAngles{ 4096 };
+	constexpr int amountOfRowPositions{ 4 };
+	float maxTableError{};
+	float maxPolynomialError{};
+	double tableErrorSum{};
+	double polynomialErrorSum{};
+	double amountOfSamples{};
+
+	for (int glossinessStep{ 0 }; glossinessStep < m_GlossinessSteps; ++glossinessStep)
+	{
+		if (histogram[glossinessStep] == 0)
+		{
+			continue;
+		}
+
+		//the last row has nothing above it to blend with
+		const int amountOfPositions{ glossinessStep < m_GlossinessSteps - 1 ? amountOfRowPositions : 1 };
+		for (int positionIdx{ 0 }; positionIdx < amountOfPositions; ++positionIdx)
+		{
+			const float glossiness{ (glossinessStep + (positionIdx / float(amountOfRowPositions))) / float(m_GlossinessSteps - 1) };
+			for (int angleIdx{ 0 }; angleIdx < amountOfAngles; angleIdx += 8)
+			{
+				float angles[8]{};
+				float table[8]{};
+				float polynomial[8]{};
+
+				for (int lane{ 0 }; lane < 8; ++lane)
+				{
+					angles[lane] = (angleIdx + lane) * (1.f / (amountOfAngles - 1));
+				}
+
+				if (isAVX2)
+				{
+					const __m256 angle{ _mm256_loadu_ps(angles) };
+					_mm256_storeu_ps(table, EvaluateTableAVX2(angle, _mm256_set1_ps(glossiness)));
+					_mm256_storeu_ps(polynomial, EvaluatePolynomialAVX2(angle, _mm256_set1_ps(glossiness)));
+				}
+				else
+				{
+					for (int lane{ 0 }; lane < 8; ++lane)
+					{
+						table[lane] = EvaluateTable(angles[lane], glossiness);
+						polynomial[lane] = EvaluatePolynomial(angles[lane], glossiness);
+					}
+				}
+
+				for (int lane{ 0 }; lane < 8; ++lane)
+				{
+					const float reference{ EvaluatePowf(angles[lane], glossiness) };
+					const float tableError{ std::abs(table[lane] - reference) };
+					const float polynomialError{ std::abs(polynomial[lane] - reference) };
+
+					maxTableError = std::max(maxTableError, tableError);
+					maxPolynomialError = std::max(maxPolynomialError, polynomialError);
+					tableErrorSum += double(tableError) * histogram[glossinessStep];
+					polynomialErrorSum += double(polynomialError) * histogram[glossinessStep];
+				}
+
+				amountOfSamples += 8.0 * histogram[glossinessStep];
+			}
+		}
+	}
+
+	const int amountOfValues{ static_cast<int>(std::count_if(histogram.begin(), histogram.end(), [](uint32_t count) { return count > 0; })) };
+
+	std::cout << "[SPECULAR POWER] against std::powf, " << amountOfValues << " glossiness values in " << pGlossinessTexture->GetPath()
+		<< " and " << amountOfRowPositions - 1 << " positions between each and the next row over " << amountOfAngles << " angles, mean weighted by texel count, " << (isAVX2 ? "AVX2" : "scalar") << " evaluators" << std::endl;
+	std::cout << "\t LOOKUP TABLE (" << m_GlossinessSteps << " x " << (m_AngleSteps + 1) << ", " << (m_Table.size() * sizeof(float)) / 1024.f << " KiB): max error "
+		<< maxTableError << ", mean error " << tableErrorSum / amountOfSamples << std::endl;
+	std::cout << "\t POLYNOMIAL: max error " << maxPolynomialError << ", mean error " << polynomialErrorSum / amountOfSamples << std::endl;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <immintrin.h>
+
+namespace dae
+{
+	class Texture;
+
+	// The phong term pow(cos angle, glossiness * shininess) of the software shaders, three ways: std::powf as the reference,
+	// a table over the 8 bit glossiness values and the cos angle, and exp2(exponent * log2(cos angle)) with polynomial log2 and exp2.
+	// The cos angle is in [0, 1] and glossiness in [0, 1]. The scalar versions only use SSE2, they agree with the AVX2 versions
+	// up to the rounding FMA saves
+	class SpecularPower final
+	{
+	public:
+		// CONSTANTS
+		//one row per value an 8 bit glossiness map can hold, filtered glossiness blends the two nearest rows
+		static constexpr int m_GlossinessSteps{ 256 };
+
+		//segments in cos angle per row, linear in between
+		static constexpr int m_AngleSteps{ 256 };
+
+		// CONSTRUCTOR
+		explicit SpecularPower(float shininess);
+
+		// MEMBER FUNCTIONS
+		float EvaluatePowf(float angle, float glossiness) const;
+		float EvaluateTable(float angle, float glossiness) const;
+		float EvaluatePolynomial(float angle, float glossiness) const;
+
+		__m256 EvaluateTableAVX2(__m256 angle, __m256 glossiness) const;
+		__m256 EvaluatePolynomialAVX2(__m256 angle, __m256 glossiness) const;
+
+		//both approximations against std::powf, for every texel of the glossiness map over a sweep of angles
+		void PrintAccuracyReport(const Texture* pGlossinessTexture) const;
+
+	private:
+		// MEMBER VARIABLES
+		float m_Shininess;
+
+		//m_GlossinessSteps rows of m_AngleSteps + 1 values
+		std::vector<float> m_Table{};
+	};
+}
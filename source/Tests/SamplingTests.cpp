@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "MipChain.h"
+#include "DecodedBlockCache.h"
+
+#undef main
+
+using namespace dae;
+
+//a texel value that is different for every texel of every block, so a texel read from the wrong block always shows
+static uint32_t GetTestTexel(int blockIdx, int texelIdx)
+{
+	return (static_cast<uint32_t>(blockIdx) * 2246822519u) ^ (static_cast<uint32_t>(texelIdx) * 3266489917u);
+}
+
+static void DecodeTestBlock(int blockIdx, uint32_t (&texels)[BlockCompression::m_TexelsPerBlock])
+{
+	for (int texelIdx{ 0 }; texelIdx < BlockCompression::m_TexelsPerBlock; ++texelIdx)
+	{
+		texels[texelIdx] = GetTestTexel(blockIdx, texelIdx);
+	}
+}
+
+//Bilinear footprints on every texel corner of every level, including the ones that wrap around the level, sampled through
+//the per thread block cache and straight from the decoded blocks. The footprint of a texel corner touches four texels,
+//up to four blocks, and some of those blocks share a cache entry
+static bool TestCachedBilinearFootprints(int width, int height)
+{
+	const MipChain mipChain{ width, height };
+
+	std::vector<uint32_t> decodedTexels(mipChain.GetAmountOfTexels());
+	for (int blockIdx{ 0 }; blockIdx < mipChain.GetAmountOfBlocks(); ++blockIdx)
+	{
+		uint32_t (&texels)[BlockCompression::m_TexelsPerBlock]{ *reinterpret_cast<uint32_t(*)[BlockCompression::m_TexelsPerBlock]>(&decodedTexels[blockIdx * BlockCompression::m_TexelsPerBlock]) };
+		DecodeTestBlock(blockIdx, texels);
+	}
+
+	DecodedBlockCache<uint32_t> cache{};
+	const auto fetchCachedBlock = [&cache, &mipChain](int blockIdx)
+		{
+			return reinterpret_cast<const uint8_t*>(cache.GetBlock(&mipChain, blockIdx, DecodeTestBlock));
+		};
+	const auto fetchDecodedBlock = [&decodedTexels](int blockIdx)
+		{
+			return reinterpret_cast<const uint8_t*>(&decodedTexels[blockIdx * BlockCompression::m_TexelsPerBlock]);
+		};
+
+	const SamplerDesc sampler{ true, 1 };
+	int amountOfFailures{ 0 };
+
+	for (int level{ 0 }; level < mipChain.GetAmountOfLevels(); ++level)
+	{
+		const MipChain::MipLevel& mip{ mipChain.GetLevel(level) };
+
+		//a footprint of 2^level texels of the most detailed level selects this level
+		const Vector2 uvDdx{ static_cast<float>(1 << level) / width, 0.f };
+		const Vector2 uvDdy{ 0.f, static_cast<float>(1 << level) / height };
+
+		for (int y{ 0 }; y < mip.height; ++y)
+		{
+			for (int x{ 0 }; x < mip.width; ++x)
+			{
+				//the corner between texels x and x + 1, y and y + 1, wrapping on the last column and row
+				const Vector2 uv{ static_cast<float>(x + 1) / mip.width, static_cast<float>(y + 1) / mip.height };
+
+				float cached[4]{};
+				float decoded[4]{};
+				mipChain.Sample(fetchCachedBlock, sampler, uv, uvDdx, uvDdy, cached);
+				mipChain.Sample(fetchDecodedBlock, sampler, uv, uvDdx, uvDdy, decoded);
+
+				if (!std::equal(std::begin(cached), std::end(cached), std::begin(decoded)))
+				{
+					if (amountOfFailures < 10)
+					{
+						std::cout << RED_COLOR_TEXT << "\t " << width << "x" << height << " level " << level << ", texel corner (" << x << ", " << y << "): cached "
+								  << cached[0] << ", decoded " << decoded[0] << RESET_COLOR_TEXT << std::endl;
+					}
+					++amountOfFailures;
+				}
+			}
+		}
+	}
+
+	if (amountOfFailures > 0)
+	{
+		std::cout << RED_COLOR_TEXT << "\t " << amountOfFailures << " cached bilinear footprints differ from the decoded blocks" << RESET_COLOR_TEXT << std::endl;
+	}
+
+	return amountOfFailures == 0;
+}
+
+int main()
+{
+	std::cout << "[SAMPLING TESTS]" << std::endl;
+
+	bool isPassing{ true };
+
+	//the resolution of the shipped textures, and one that is not a power of two
+	isPassing &= TestCachedBilinearFootprints(1024, 1024);
+	isPassing &= TestCachedBilinearFootprints(300, 200);
+
+	std::cout << (isPassing ? GREEN_COLOR_TEXT "\t passed" : RED_COLOR_TEXT "\t failed") << RESET_COLOR_TEXT << std::endl;
+	return isPassing ? 0 : 1;
+}
@@ -1,59 +1,470 @@
 #include "pch.h"
 #include "Texture.h"
+#include "DecodedBlockCache.h"
+#include "CpuFeatures.h"
+#include "AllocationTracker.h"
 #include <cassert>
+#include <cstring>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <immintrin.h>
 
 using namespace dae;
 
-Texture::Texture(SDL_Surface* pSurface, ID3D11Device* pDevice) :
+//header of the block files written next to the images, followed by the blocks of every level
+struct BlockFileHeader
+{
+	char magic[4]{ 'B', 'C', 'T', 'X' };
+	uint32_t format{};
+	uint32_t width{};
+	uint32_t height{};
+};
+
+//2x2 box filter from one linear RGBA8 level to the next, four destination texels per AVX2 iteration.
+//Without AVX2 every texel takes the scalar path the last texels of a row take
+static void DownsampleLevel(const uint32_t* pSource, int sourceWidth, int sourceHeight, uint32_t* pDestination, int width, int height)
+{
+	const bool isAVX2{ CpuFeatures::GetInstructionSet() >= InstructionSet::avx2 };
+
+	for (int y{ 0 }; y < height; ++y)
+	{
+		//a source of odd size repeats its last row and column
+		const uint32_t* pTopRow{ pSource + ((y * 2) * sourceWidth) };
+		const uint32_t* pBottomRow{ pSource + (std::min((y * 2) + 1, sourceHeight - 1) * sourceWidth) };
+		uint32_t* pDestinationRow{ pDestination + (y * width) };
+
+		int x{ 0 };
+		for (; isAVX2 && x + 4 <= width && (x * 2) + 8 <= sourceWidth; x += 4)
+		{
+			//no AVX2 instruction may run before the check, so the constants are made in the loop
+			const __m256i zero{ _mm256_setzero_si256() };
+			const __m256i rounding{ _mm256_set1_epi16(2) };
+
+			const __m256i top{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pTopRow + (x * 2))) };
+			const __m256i bottom{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pBottomRow + (x * 2))) };
+
+			//widen to 16 bits per channel and add the rows: source texels 0,1 (4,5) in the low halves of the lanes, 2,3 (6,7) in the high halves
+			const __m256i low{ _mm256_add_epi16(_mm256_unpacklo_epi8(top, zero), _mm256_unpacklo_epi8(bottom, zero)) };
+			const __m256i high{ _mm256_add_epi16(_mm256_unpackhi_epi8(top, zero), _mm256_unpackhi_epi8(bottom, zero)) };
+
+			//add the horizontal neighbours, every lane ends up with two destination texels
+			const __m256i lowSum{ _mm256_add_epi16(low, _mm256_srli_si256(low, 8)) };
+			const __m256i highSum{ _mm256_add_epi16(high, _mm256_srli_si256(high, 8)) };
+			const __m256i sum{ _mm256_unpacklo_epi64(lowSum, highSum) };
+
+			const __m256i average{ _mm256_srli_epi16(_mm256_add_epi16(sum, rounding), 2) };
+			const __m256i packed{ _mm256_packus_epi16(average, average) };
+
+			//the destination texels are the low 64 bits of both lanes
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pDestinationRow + x), _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0b1000)));
+		}
+
+		for (; x < width; ++x)
+		{
+			const int leftX{ x * 2 };
+			const int rightX{ std::min(leftX + 1, sourceWidth - 1) };
+			const uint32_t texels[4]{ pTopRow[leftX], pTopRow[rightX], pBottomRow[leftX], pBottomRow[rightX] };
+
+			uint32_t average{};
+			for (int channelShift{ 0 }; channelShift < 32; channelShift += 8)
+			{
+				uint32_t sum{ 2 };
+				for (const uint32_t texel : texels)
+				{
+					sum += (texel >> channelShift) & 0xFF;
+				}
+				average |= (sum >> 2) << channelShift;
+			}
+			pDestinationRow[x] = average;
+		}
+	}
+}
+
+//blocks are stored next to the image, one file per format the image is encoded to
+static std::string GetBlockFilePath(const std::string& path, TextureFormat format)
+{
+	constexpr const char* extensions[]{ ".bc1", ".bc3", ".bc4", ".bc5", ".rg16" };
+	return std::filesystem::path{ path }.replace_extension(extensions[static_cast<int>(format)]).string();
+}
+
+//a block file can be used on its own, or when it was written after the image last changed
+static bool IsBlockFileUpToDate(const std::string& path, const std::string& blockPath)
+{
+	std::error_code error{};
+	const std::filesystem::file_time_type blockTime{ std::filesystem::last_write_time(blockPath, error) };
+	if (error)
+	{
+		return false;
+	}
+
+	const std::filesystem::file_time_type imageTime{ std::filesystem::last_write_time(path, error) };
+	return error || blockTime >= imageTime;
+}
+
+Texture::Texture(const std::string& path, TextureFormat format, Residency residency, ID3D11Device* pDevice, const TextureBake& bake) :
 	m_pResource{},
 	m_pSRV{},
-	m_pSurface{ pSurface },
-	m_pSurfacePixels{ (uint32_t*)pSurface->pixels }
+	m_Format{ format },
+	m_Path{ path },
+	m_Bake{ bake }
 {	
-	
+	LoadBlocks();
+
+	if (residency != Residency::cpuOnly)
+	{
+		CreateShaderResource(pDevice);
+	}
+
+	//the upload is done, the blocks can be loaded again when the software path asks for them
+	if (residency == Residency::gpuOnly)
+	{
+		SetCpuResident(false);
+	}
 }
 
 Texture::~Texture()
 {	
-	m_pResource->Release();
-	m_pSRV->Release();
+	if (m_pResource != nullptr)
+	{
+		m_pResource->Release();
+	}
+
+	if (m_pSRV != nullptr)
+	{
+		m_pSRV->Release();
+	}
+
+	delete[] m_pBlocks;
+}
+
+void Texture::LoadBlocks()
+{
+	const AllocationTracker::Scope allocationScope{ Subsystem::texture };
+
+	//Encoding is the slow part of loading, so the blocks of an earlier run are reused when they are still valid
+	const std::string blockPath{ GetBlockFilePath(m_Path, m_Format) };
+	const bool isBakeUpToDate{ m_Bake.sourcePath.empty() || IsBlockFileUpToDate(m_Bake.sourcePath, blockPath) };
+
+	if (!isBakeUpToDate || !IsBlockFileUpToDate(m_Path, blockPath) || !ReadBlockFile(blockPath))
+	{
+		SDL_Surface* pSurface{ IMG_Load(m_Path.data()) };
+		assert(pSurface != nullptr);
+
+		EncodeImage(pSurface);
+		SDL_FreeSurface(pSurface);
+
+		WriteBlockFile(blockPath);
+	}
+}
+
+void Texture::EncodeImage(SDL_Surface* pSurface)
+{
+	m_MipChain = MipChain{ pSurface->w, pSurface->h };
+
+	//Convert the surface once, whatever its pixel format, to 32 bit pixels with r in the lowest byte and a in the highest.
+	//A 24 bit PNG loads as 3 bytes per pixel, so the pixels can't be read as they are. The levels are only needed until they are encoded
+	SDL_Surface* pConvertedSurface{ SDL_ConvertSurfaceFormat(pSurface, SDL_PIXELFORMAT_ABGR8888, 0) };
+	assert(pConvertedSurface != nullptr);
+
+	std::vector<std::vector<uint32_t>> linearLevels(m_MipChain.GetAmountOfLevels());
+	linearLevels[0].resize(size_t(pSurface->w) * pSurface->h);
+
+	for (int y{ 0 }; y < pConvertedSurface->h; ++y)
+	{
+		const uint32_t* pRow{ reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(pConvertedSurface->pixels) + (size_t(y) * pConvertedSurface->pitch)) };
+		std::copy(pRow, pRow + pConvertedSurface->w, linearLevels[0].begin() + (size_t(y) * pSurface->w));
+	}
+
+	//counted as one copy, the rows are only split by the surface's pitch
+	AllocationTracker::CountCopy(linearLevels[0].size() * sizeof(uint32_t));
+
+	SDL_FreeSurface(pConvertedSurface);
+
+	//every next level is the box filtered previous one
+	for (int level{ 1 }; level < m_MipChain.GetAmountOfLevels(); ++level)
+	{
+		const MipChain::MipLevel& source{ m_MipChain.GetLevel(level - 1) };
+		const MipChain::MipLevel& destination{ m_MipChain.GetLevel(level) };
+
+		linearLevels[level].resize(size_t(destination.width) * destination.height);
+		DownsampleLevel(linearLevels[level - 1].data(), source.width, source.height, linearLevels[level].data(), destination.width, destination.height);
+	}
+
+	if (m_Bake.bakeLevels)
+	{
+		m_Bake.bakeLevels(m_MipChain, linearLevels);
+	}
+
+	const int blockBytes{ GetBlockBytes(m_Format) };
+	m_pBlocks = new uint8_t[size_t(m_MipChain.GetAmountOfBlocks()) * blockBytes]{};
+
+	const Subsystem subsystem{ AllocationTracker::GetCurrentSubsystem() };
+	for (int level{ 0 }; level < m_MipChain.GetAmountOfLevels(); ++level)
+	{
+		const MipChain::MipLevel& mip{ m_MipChain.GetLevel(level) };
+		const std::vector<uint32_t>& linearLevel{ linearLevels[level] };
+
+		//block rows are independent, encode them in parallel
+		std::vector<int> blockRows((mip.height + MipChain::m_TexelTileSize - 1) / MipChain::m_TexelTileSize);
+		std::iota(blockRows.begin(), blockRows.end(), 0);
+
+		std::for_each(std::execution::par, blockRows.begin(), blockRows.end(), [&](int blockRow)
+			{
+				const AllocationTracker::Scope allocationScope{ subsystem };
+				for (int blockColumn{ 0 }; blockColumn < mip.tilesPerRow; ++blockColumn)
+				{
+					//levels smaller than a block repeat their last row and column
+					uint32_t texels[BlockCompression::m_TexelsPerBlock]{};
+					for (int texelIdx{ 0 }; texelIdx < BlockCompression::m_TexelsPerBlock; ++texelIdx)
+					{
+						const int x{ std::min((blockColumn * MipChain::m_TexelTileSize) + (texelIdx % MipChain::m_TexelTileSize), mip.width - 1) };
+						const int y{ std::min((blockRow * MipChain::m_TexelTileSize) + (texelIdx / MipChain::m_TexelTileSize), mip.height - 1) };
+						texels[texelIdx] = linearLevel[x + (y * mip.width)];
+					}
+
+					uint8_t channel[BlockCompression::m_TexelsPerBlock]{};
+					const auto extractChannel = [&](int channelIdx)
+						{
+							for (int texelIdx{ 0 }; texelIdx < BlockCompression::m_TexelsPerBlock; ++texelIdx)
+							{
+								channel[texelIdx] = static_cast<uint8_t>(texels[texelIdx] >> (channelIdx * 8));
+							}
+						};
+
+					uint8_t* pBlock{ m_pBlocks + (size_t(m_MipChain.GetBlockIndex(blockColumn * MipChain::m_TexelTileSize, blockRow * MipChain::m_TexelTileSize, level)) * blockBytes) };
+
+					switch (m_Format)
+					{
+					case TextureFormat::bc1:
+						BlockCompression::EncodeBC1Block(texels, pBlock);
+						break;
+					case TextureFormat::bc3:
+						extractChannel(3);
+						BlockCompression::EncodeBC4Block(channel, pBlock);
+						BlockCompression::EncodeBC1Block(texels, pBlock + BlockCompression::m_BC4BlockBytes);
+						break;
+					case TextureFormat::bc4:
+						//greyscale maps keep the average of their channels
+						for (int texelIdx{ 0 }; texelIdx < BlockCompression::m_TexelsPerBlock; ++texelIdx)
+						{
+							const uint32_t texel{ texels[texelIdx] };
+							channel[texelIdx] = static_cast<uint8_t>(((texel & 0xFF) + ((texel >> 8) & 0xFF) + ((texel >> 16) & 0xFF) + 1) / 3);
+						}
+						BlockCompression::EncodeBC4Block(channel, pBlock);
+						break;
+					case TextureFormat::bc5:
+						extractChannel(0);
+						BlockCompression::EncodeBC4Block(channel, pBlock);
+						extractChannel(1);
+						BlockCompression::EncodeBC4Block(channel, pBlock + BlockCompression::m_BC4BlockBytes);
+						break;
+					case TextureFormat::rg16:
+						std::memcpy(pBlock, texels, sizeof(texels));
+						break;
+					}
+				}
+			});
+	}
+}
+
+bool Texture::ReadBlockFile(const std::string& blockPath)
+{
+	std::ifstream file{ blockPath, std::ios::binary };
+
+	BlockFileHeader header{};
+	const BlockFileHeader expectedHeader{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if (!file || std::memcmp(header.magic, expectedHeader.magic, sizeof(header.magic)) != 0 || header.format != static_cast<uint32_t>(m_Format)
+		|| header.width == 0 || header.height == 0 || header.width > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION || header.height > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION)
+	{
+		return false;
+	}
+
+	MipChain mipChain{ static_cast<int>(header.width), static_cast<int>(header.height) };
+	const size_t amountOfBytes{ size_t(mipChain.GetAmountOfBlocks()) * GetBlockBytes(m_Format) };
+
+	uint8_t* pBlocks{ new uint8_t[amountOfBytes] };
+	file.read(reinterpret_cast<char*>(pBlocks), amountOfBytes);
+
+	if (!file)
+	{
+		delete[] pBlocks;
+		return false;
+	}
+
+	m_MipChain = std::move(mipChain);
+	m_pBlocks = pBlocks;
+	return true;
+}
+
+void Texture::WriteBlockFile(const std::string& blockPath) const
+{
+	//a missing or read only folder only means the next run encodes again
+	std::ofstream file{ blockPath, std::ios::binary };
+
+	BlockFileHeader header{};
+	header.format = static_cast<uint32_t>(m_Format);
+	header.width = static_cast<uint32_t>(GetWidth());
+	header.height = static_cast<uint32_t>(GetHeight());
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(m_pBlocks), size_t(m_MipChain.GetAmountOfBlocks()) * GetBlockBytes(m_Format));
+}
+
+void Texture::DecodeBlock(int blockIdx, uint32_t (&texels)[BlockCompression::m_TexelsPerBlock]) const
+{
+	//channels a format does not store read as 0 and alpha as 255, like on the GPU
+	uint8_t planes[4][BlockCompression::m_TexelsPerBlock]{};
+	std::fill_n(planes[3], BlockCompression::m_TexelsPerBlock, uint8_t{ 255 });
+
+	const uint8_t* pBlock{ GetBlock(blockIdx) };
+
+	switch (m_Format)
+	{
+	case TextureFormat::bc1:
+		BlockCompression::DecodeBC1Block(pBlock, planes[0], planes[1], planes[2]);
+		break;
+	case TextureFormat::bc3:
+		BlockCompression::DecodeBC4Block(pBlock, planes[3]);
+		BlockCompression::DecodeBC1Block(pBlock + BlockCompression::m_BC4BlockBytes, planes[0], planes[1], planes[2]);
+		break;
+	case TextureFormat::bc4:
+		BlockCompression::DecodeBC4Block(pBlock, planes[0]);
+		break;
+	case TextureFormat::bc5:
+		BlockCompression::DecodeBC4Block(pBlock, planes[0]);
+		BlockCompression::DecodeBC4Block(pBlock + BlockCompression::m_BC4BlockBytes, planes[1]);
+		break;
+	case TextureFormat::rg16:
+		//only the high byte of both channels fits an RGBA8 texel
+		for (int texelIdx{ 0 }; texelIdx < BlockCompression::m_TexelsPerBlock; ++texelIdx)
+		{
+			planes[0][texelIdx] = pBlock[(texelIdx * 4) + 1];
+			planes[1][texelIdx] = pBlock[(texelIdx * 4) + 3];
+		}
+		break;
+	}
+
+	BlockCompression::InterleavePlanes(planes, reinterpret_cast<uint8_t*>(texels));
+}
+
+ColorRGB Texture::Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, const SamplerDesc& sampler) const
+{
+	//blocks are decoded into a cache per thread, so neighbouring samples reuse them without locking
+	thread_local DecodedBlockCache<uint32_t> blockCache{};
+	DecodedBlockCache<uint32_t>& cache{ blockCache };
+
+	const auto fetchBlock = [this, &cache](int blockIdx)
+		{
+			const uint32_t* pTexels{ cache.GetBlock(this, blockIdx, [this](int idx, uint32_t (&texels)[BlockCompression::m_TexelsPerBlock]) { DecodeBlock(idx, texels); }) };
+			return reinterpret_cast<const uint8_t*>(pTexels);
+		};
+
+	float channels[4]{};
+	m_MipChain.Sample(fetchBlock, sampler, uv, uvDdx, uvDdy, channels);
+
+	constexpr float byteToFloat{ 1.f / 255.f };
+	return ColorRGB{ channels[0] * byteToFloat, channels[1] * byteToFloat, channels[2] * byteToFloat };
+}
+
+const uint8_t* Texture::GetBlock(int blockIdx) const
+{
+	assert(m_pBlocks != nullptr);
+	return m_pBlocks + (size_t(blockIdx) * GetBlockBytes(m_Format));
+}
 
-	SDL_FreeSurface(m_pSurface); 
+TextureFormat Texture::GetFormat() const
+{
+	return m_Format;
+}
+
+int Texture::GetWidth() const
+{
+	return m_MipChain.GetLevel(0).width;
+}
+
+int Texture::GetHeight() const
+{
+	return m_MipChain.GetLevel(0).height;
+}
+
+void Texture::SetCpuResident(bool isCpuResident)
+{
+	if (isCpuResident && m_pBlocks == nullptr)
+	{
+		LoadBlocks();
+	}
+	else if (!isCpuResident)
+	{
+		//a texture that is not on the GPU either would have nothing left
+		assert(m_pResource != nullptr);
+
+		delete[] m_pBlocks;
+		m_pBlocks = nullptr;
+	}
 }
 
-ColorRGB Texture::Sample(const Vector2& uv) const
+Residency Texture::GetResidency() const
 {
-	//Sample the correct texel for the given uv
-	const float px{ m_pSurface->w * uv.x };
-	const float py{ m_pSurface->h * uv.y };
-	const uint32_t pIndex{ static_cast<uint32_t>(px) + (static_cast<uint32_t>(py) * m_pSurface->w) };
+	if (m_pResource == nullptr)
+	{
+		return Residency::cpuOnly;
+	}
+
+	return m_pBlocks != nullptr ? Residency::both : Residency::gpuOnly;
+}
 
-	uint8_t r{}; 
-	uint8_t g{}; 
-	uint8_t b{}; 
+const std::string& Texture::GetPath() const
+{
+	return m_Path;
+}
 
-	SDL_GetRGB(m_pSurfacePixels[pIndex], m_pSurface->format, &r, &g, &b);  
+size_t Texture::GetCpuBytes() const
+{
+	return m_pBlocks != nullptr ? size_t(m_MipChain.GetAmountOfBlocks()) * GetBlockBytes(m_Format) : 0;
+}
 
-	float rFloat{ r / 255.f }; 
-	float gFloat{ g / 255.f }; 
-	float bFloat{ b / 255.f }; 
+size_t Texture::GetGpuBytes() const
+{
+	//the GPU stores the blocks as they are uploaded, uncompressed levels smaller than a block are a few bytes less
+	return m_pResource != nullptr ? size_t(m_MipChain.GetAmountOfBlocks()) * GetBlockBytes(m_Format) : 0;
+}
 
-	return ColorRGB{ rFloat,gFloat,bFloat }; 
+int Texture::GetBlockBytes(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::bc3:
+	case TextureFormat::bc5:
+		return 2 * BlockCompression::m_BC4BlockBytes;
+	case TextureFormat::rg16:
+		return BlockCompression::m_TexelsPerBlock * static_cast<int>(sizeof(uint32_t));
+	default:
+		return BlockCompression::m_BC1BlockBytes;
+	}
 }
 
-Texture* Texture::LoadTexture(const std::string& path, ID3D11Device* pDevice)
+Texture* Texture::LoadTexture(const std::string& path, TextureFormat format, Residency residency, ID3D11Device* pDevice, const TextureBake& bake)
 {
-	SDL_Surface* pSurface{ IMG_Load(path.data()) };
+	return new Texture{ path, format, residency, pDevice, bake };
+}
 
-	assert(pSurface != nullptr);
+void Texture::CreateShaderResource(ID3D11Device* pDevice)
+{
+	const AllocationTracker::Scope allocationScope{ Subsystem::texture };
 
-	Texture* pTexture = new Texture{ pSurface, pDevice };
+	const UINT amountOfLevels{ static_cast<UINT>(m_MipChain.GetAmountOfLevels()) };
+	const int blockBytes{ GetBlockBytes(m_Format) };
 
-	DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	constexpr DXGI_FORMAT formats[]{ DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC4_UNORM, DXGI_FORMAT_BC5_UNORM, DXGI_FORMAT_R16G16_UNORM };
+	DXGI_FORMAT format = formats[static_cast<int>(m_Format)];
 	D3D11_TEXTURE2D_DESC desc{};
-	desc.Width = pSurface->w;
-	desc.Height = pSurface->h;
-	desc.MipLevels = 1;
+	desc.Width = m_MipChain.GetLevel(0).width;
+	desc.Height = m_MipChain.GetLevel(0).height;
+	desc.MipLevels = amountOfLevels;
 	desc.ArraySize = 1;
 	desc.Format = format;
 	desc.SampleDesc.Count = 1;
@@ -63,24 +474,51 @@ Texture* Texture::LoadTexture(const std::string& path, ID3D11Device* pDevice)
 	desc.CPUAccessFlags = 0;
 	desc.MiscFlags = 0;
 
-	D3D11_SUBRESOURCE_DATA initData{};
-	initData.pSysMem = pSurface->pixels;
-	initData.SysMemPitch = static_cast<UINT>(pSurface->pitch);
-	initData.SysMemSlicePitch = static_cast<UINT>(pSurface->h * pSurface->pitch);
+	//one subresource per mip level, the blocks go up as they are stored: a row of blocks is one pitch
+	std::vector<D3D11_SUBRESOURCE_DATA> initData(amountOfLevels);
+	std::vector<std::vector<uint32_t>> linearLevels{};
+	linearLevels.reserve(amountOfLevels);
+	for (UINT level{ 0 }; level < amountOfLevels; ++level)
+	{
+		const MipChain::MipLevel& mip{ m_MipChain.GetLevel(level) };
+		const int amountOfBlockRows{ (mip.height + MipChain::m_TexelTileSize - 1) / MipChain::m_TexelTileSize };
+
+		initData[level].pSysMem = GetBlock(m_MipChain.GetBlockIndex(0, 0, level));
+		initData[level].SysMemPitch = static_cast<UINT>(mip.tilesPerRow * blockBytes);
+		initData[level].SysMemSlicePitch = static_cast<UINT>(mip.tilesPerRow * amountOfBlockRows * blockBytes);
+
+		//uncompressed formats are uploaded row by row, their blocks are split up again
+		if (m_Format == TextureFormat::rg16)
+		{
+			std::vector<uint32_t>& linearLevel{ linearLevels.emplace_back(size_t(mip.width) * mip.height) };
+			for (int y{ 0 }; y < mip.height; ++y)
+			{
+				for (int x{ 0 }; x < mip.width; ++x)
+				{
+					const uint8_t* pTexel{ GetBlock(m_MipChain.GetBlockIndex(x, y, level)) + (MipChain::GetTexelInBlockIndex(x, y) * sizeof(uint32_t)) };
+					std::memcpy(&linearLevel[x + (size_t(y) * mip.width)], pTexel, sizeof(uint32_t));
+				}
+			}
+
+			AllocationTracker::CountCopy(linearLevel.size() * sizeof(uint32_t));
+
+			initData[level].pSysMem = linearLevel.data();
+			initData[level].SysMemPitch = static_cast<UINT>(mip.width * sizeof(uint32_t));
+			initData[level].SysMemSlicePitch = static_cast<UINT>(mip.width * mip.height * sizeof(uint32_t));
+		}
+	}
 
-	HRESULT hr = pDevice->CreateTexture2D(&desc, &initData, &pTexture->m_pResource);
+	HRESULT hr = pDevice->CreateTexture2D(&desc, initData.data(), &m_pResource);
 
 	D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
 	SRVDesc.Format = format;
 	SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-	SRVDesc.Texture2D.MipLevels = 1;
+	SRVDesc.Texture2D.MipLevels = amountOfLevels;
 
-	if (pTexture->m_pResource != nullptr)
+	if (m_pResource != nullptr)
 	{
-		hr = pDevice->CreateShaderResourceView(pTexture->m_pResource, &SRVDesc, &pTexture->m_pSRV);
+		hr = pDevice->CreateShaderResourceView(m_pResource, &SRVDesc, &m_pSRV);
 	}
-	
-	return pTexture;  
 }
 
 ID3D11ShaderResourceView* Texture::GetShaderResourceView() const
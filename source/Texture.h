@@ -1,12 +1,33 @@
 #pragma once
+#include "MipChain.h"
+#include "Residency.h"
+#include <functional>
 
 namespace dae
 {
+	// Format a texture is stored and uploaded in, picked by what the map holds. Every format is stored in 4x4 blocks
+	enum class TextureFormat
+	{
+		bc1,	//opaque colour
+		bc3,	//colour with alpha
+		bc4,	//greyscale
+		bc5,	//two channels, tangent space normals
+		rg16	//two 16 bit channels, not compressed, octahedral object space normals
+	};
+
+	// Turns the box filtered RGBA8 levels of an image into the 32 bit texels that are stored, for maps derived from more than their image.
+	// The stored blocks are out of date when the source the bake reads changes as well
+	struct TextureBake
+	{
+		std::string sourcePath{};
+		std::function<void(const MipChain& mipChain, std::vector<std::vector<uint32_t>>& levels)> bakeLevels{};
+	};
+
 	class Texture
 	{
 	public:
 		// CONSTRUCTOR AND DESTRUCTOR
-		Texture(SDL_Surface* pSurface, ID3D11Device* pDevice);
+		Texture(const std::string& path, TextureFormat format, Residency residency, ID3D11Device* pDevice, const TextureBake& bake = TextureBake{});
 		~Texture();
 
 		// RULE OF FIVE
@@ -16,19 +37,48 @@ namespace dae
 		Texture& operator=(Texture&& other) noexcept = delete;
 
 		// SOFTWARE MEMBER FUNCTION
-		ColorRGB Sample(const Vector2& uv) const;
+		ColorRGB Sample(const Vector2& uv, const Vector2& uvDdx, const Vector2& uvDdy, const SamplerDesc& sampler) const;
+		const uint8_t* GetBlock(int blockIdx) const;
+		TextureFormat GetFormat() const;
+		int GetWidth() const;
+		int GetHeight() const;
+
+		//loads the blocks again from the block file or the image when they were dropped, or drops them
+		void SetCpuResident(bool isCpuResident);
+
+		static int GetBlockBytes(TextureFormat format);
+
+		// SHARED MEMBER FUNCTIONS
+		Residency GetResidency() const;
+		const std::string& GetPath() const;
+		size_t GetCpuBytes() const;
+		size_t GetGpuBytes() const;
 
 		// HARDWARE MEMBER FUNCTIONS
-		static Texture* LoadTexture(const std::string& path, ID3D11Device* pDevice);
+		static Texture* LoadTexture(const std::string& path, TextureFormat format, Residency residency, ID3D11Device* pDevice, const TextureBake& bake = TextureBake{});
 		ID3D11ShaderResourceView* GetShaderResourceView() const;
 
 	private:
 		// SOFTWARE MEMBER VARIABLES
-		SDL_Surface* m_pSurface{ nullptr };
-		uint32_t* m_pSurfacePixels{ nullptr };
+		//the compressed blocks of every mip level, the only copy of the image kept on the CPU and only while it is CPU resident
+		uint8_t* m_pBlocks{ nullptr };
+		MipChain m_MipChain{};
+		TextureFormat m_Format;
+		std::string m_Path{};
+		TextureBake m_Bake{};
 
 		// HARDWARE MEMBER VARIABLES
 		ID3D11Texture2D* m_pResource;
 		ID3D11ShaderResourceView* m_pSRV;
+
+		// SOFTWARE MEMBER FUNCTIONS
+		void LoadBlocks();
+		void EncodeImage(SDL_Surface* pSurface);
+		bool ReadBlockFile(const std::string& blockPath);
+		void WriteBlockFile(const std::string& blockPath) const;
+		void DecodeBlock(int blockIdx, uint32_t (&texels)[BlockCompression::m_TexelsPerBlock]) const;
+
+		// HARDWARE MEMBER FUNCTIONS
+		void CreateShaderResource(ID3D11Device* pDevice);
 	};
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 #include <cassert>
 #include <fstream>
+#include <unordered_map>
 #include "Math.h"
+#include "AllocationTracker.h"
 
 //#define DISABLE_OBJ
 
@@ -14,6 +16,8 @@ namespace dae
 #pragma warning(disable : 4505) //Warning unreferenced local function
 		static bool ParseOBJ(const std::string& filename, std::vector<Vertex_PosCol>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
 		{
+			const AllocationTracker::Scope allocationScope{ Subsystem::utils };
+
 #ifdef DISABLE_OBJ
 
 				//Enable the code below after uncommenting all the vertex attributes of DataTypes::Vertex
@@ -30,6 +34,9 @@ namespace dae
 				std::vector<Vector3> normals{};
 				std::vector<Vector2> UVs{};
 
+				//every unique (position, uv, normal) index tuple becomes one vertex, shared by all faces using it
+				std::unordered_map<uint64_t, uint32_t> vertexLookup{};
+
 				vertices.clear();
 				indices.clear();
 
@@ -76,7 +83,7 @@ namespace dae
 						//
 						// Faces or triangles
 						Vertex_PosCol vertex{}; 
-						size_t iPosition, iTexCoord, iNormal;
+						size_t iPosition, iTexCoord{}, iNormal{};
 
 						uint32_t tempIndices[3];
 						for (size_t iFace = 0; iFace < 3; iFace++)
@@ -106,9 +113,18 @@ namespace dae
 								}
 							}
 
-							vertices.push_back(vertex);
-							tempIndices[iFace] = uint32_t(vertices.size()) - 1;
-							//indices.push_back(uint32_t(vertices.size()) - 1);
+							//21 bits per index, an index past that would share its key with another tuple
+							constexpr size_t keyIndexLimit{ size_t(1) << 21 };
+							assert(iPosition < keyIndexLimit && iTexCoord < keyIndexLimit && iNormal < keyIndexLimit);
+							const uint64_t vertexKey{ (uint64_t(iPosition) << 42) | (uint64_t(iTexCoord) << 21) | uint64_t(iNormal) };
+							const auto [it, isNewVertex] = vertexLookup.try_emplace(vertexKey, uint32_t(vertices.size()));
+
+							if (isNewVertex)
+							{
+								vertices.push_back(vertex);
+							}
+
+							tempIndices[iFace] = it->second;
 						}
 
 						indices.push_back(tempIndices[0]);
@@ -145,7 +161,13 @@ namespace dae
 					const Vector3 edge1 = p2 - p0;
 					const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
 					const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
-					float r = 1.f / Vector2::Cross(diffX, diffY);
+
+					//no uv area, it would only spread a non finite tangent over the shared vertices
+					const float uvArea = Vector2::Cross(diffX, diffY);
+					if (uvArea == 0.f)
+						continue;
+
+					float r = 1.f / uvArea;
 
 					Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
 					vertices[index0].tangent += tangent;
@@ -156,7 +178,12 @@ namespace dae
 				//Fix the tangents per vertex now because we accumulated
 				for (auto& v : vertices)
 				{
-					v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
+					//vertices only used by faces without uv area have nothing accumulated, any tangent perpendicular to the normal will do
+					const Vector3 tangent = Vector3::Reject(v.tangent, v.normal);
+					if (tangent.SqrMagnitude() > 0.f)
+						v.tangent = tangent.Normalized();
+					else
+						v.tangent = Vector3::Reject(std::abs(v.normal.x) < 0.9f ? Vector3::UnitX : Vector3::UnitY, v.normal).Normalized();
 
 					if (flipAxisAndWinding)
 					{
@@ -170,6 +197,205 @@ namespace dae
 				return true;
 #endif
 			}
+
+		//Reorders the triangles so vertices are reused while they are still in the post-transform cache (Forsyth's linear-speed optimizer)
+		static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+		{
+			const AllocationTracker::Scope allocationScope{ Subsystem::utils };
+
+			constexpr int cacheSize{ 32 };
+			constexpr uint32_t noTriangle{ UINT32_MAX };
+			const uint32_t triangleCount{ uint32_t(indices.size() / 3) };
+
+			//triangles still to be emitted per vertex, one contiguous range per vertex
+			std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+			for (const uint32_t index : indices)
+			{
+				++remainingTriangles[index];
+			}
+
+			std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+			for (size_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx)
+			{
+				adjacencyOffsets[vertexIdx + 1] = adjacencyOffsets[vertexIdx] + remainingTriangles[vertexIdx];
+			}
+
+			std::vector<uint32_t> adjacency(indices.size());
+			std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t triangleIdx = 0; triangleIdx < triangleCount; ++triangleIdx)
+			{
+				for (int corner = 0; corner < 3; ++corner)
+				{
+					adjacency[adjacencyFill[indices[size_t(triangleIdx) * 3 + corner]]++] = triangleIdx;
+				}
+			}
+
+			std::vector<int> cachePositions(vertexCount, -1);
+			std::vector<float> vertexScores(vertexCount, 0.f);
+			std::vector<float> triangleScores(triangleCount, 0.f);
+			std::vector<bool> isTriangleEmitted(triangleCount, false);
+
+			//recently used vertices score high, the last triangle's a bit lower so strips do not dominate,
+			//vertices with few triangles left score high so they leave the mesh early
+			const auto calculateVertexScore = [&](uint32_t vertexIdx)
+				{
+					if (remainingTriangles[vertexIdx] == 0)
+						return -1.f;
+
+					float score = 0.f;
+					const int cachePosition = cachePositions[vertexIdx];
+					if (cachePosition >= 0)
+					{
+						if (cachePosition < 3)
+							score = 0.75f;
+						else
+							score = powf(1.f - float(cachePosition - 3) / (cacheSize - 3), 1.5f);
+					}
+
+					return score + 2.f / sqrtf(float(remainingTriangles[vertexIdx]));
+				};
+
+			for (uint32_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx)
+			{
+				vertexScores[vertexIdx] = calculateVertexScore(vertexIdx);
+			}
+
+			for (uint32_t triangleIdx = 0; triangleIdx < triangleCount; ++triangleIdx)
+			{
+				for (int corner = 0; corner < 3; ++corner)
+				{
+					triangleScores[triangleIdx] += vertexScores[indices[size_t(triangleIdx) * 3 + corner]];
+				}
+			}
+
+			std::vector<uint32_t> optimizedIndices{};
+			optimizedIndices.reserve(indices.size());
+
+			std::vector<uint32_t> cache{};
+			std::vector<uint32_t> newCache{};
+			cache.reserve(cacheSize + 3);
+			newCache.reserve(cacheSize + 3);
+
+			uint32_t bestTriangle = noTriangle;
+			for (uint32_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+			{
+				//nothing in the cache has triangles left, fall back to the best triangle overall
+				if (bestTriangle == noTriangle)
+				{
+					float bestScore = -1.f;
+					for (uint32_t triangleIdx = 0; triangleIdx < triangleCount; ++triangleIdx)
+					{
+						if (!isTriangleEmitted[triangleIdx] && triangleScores[triangleIdx] > bestScore)
+						{
+							bestScore = triangleScores[triangleIdx];
+							bestTriangle = triangleIdx;
+						}
+					}
+				}
+
+				const uint32_t* pTriangle = &indices[size_t(bestTriangle) * 3];
+				optimizedIndices.insert(optimizedIndices.end(), pTriangle, pTriangle + 3);
+				isTriangleEmitted[bestTriangle] = true;
+
+				//the triangle is no longer left for its vertices
+				for (int corner = 0; corner < 3; ++corner)
+				{
+					const uint32_t vertexIdx = pTriangle[corner];
+					uint32_t* pAdjacency = &adjacency[adjacencyOffsets[vertexIdx]];
+					uint32_t& remaining = remainingTriangles[vertexIdx];
+
+					std::swap(*std::find(pAdjacency, pAdjacency + remaining, bestTriangle), pAdjacency[remaining - 1]);
+					--remaining;
+				}
+
+				//the triangle's vertices move to the front of the LRU cache
+				newCache.assign(pTriangle, pTriangle + 3);
+				for (const uint32_t vertexIdx : cache)
+				{
+					if (vertexIdx != pTriangle[0] && vertexIdx != pTriangle[1] && vertexIdx != pTriangle[2])
+						newCache.push_back(vertexIdx);
+				}
+
+				for (int cachePosition = 0; cachePosition < int(newCache.size()); ++cachePosition)
+				{
+					const uint32_t vertexIdx = newCache[cachePosition];
+					cachePositions[vertexIdx] = cachePosition < cacheSize ? cachePosition : -1;
+					vertexScores[vertexIdx] = calculateVertexScore(vertexIdx);
+				}
+
+				//rescore the triangles around everything that moved, and pick the best one as the next triangle
+				bestTriangle = noTriangle;
+				float bestScore = -1.f;
+				for (const uint32_t vertexIdx : newCache)
+				{
+					const uint32_t* pAdjacency = &adjacency[adjacencyOffsets[vertexIdx]];
+					for (uint32_t adjacencyIdx = 0; adjacencyIdx < remainingTriangles[vertexIdx]; ++adjacencyIdx)
+					{
+						const uint32_t triangleIdx = pAdjacency[adjacencyIdx];
+						const uint32_t* pAdjacentTriangle = &indices[size_t(triangleIdx) * 3];
+
+						triangleScores[triangleIdx] = vertexScores[pAdjacentTriangle[0]] + vertexScores[pAdjacentTriangle[1]] + vertexScores[pAdjacentTriangle[2]];
+						if (triangleScores[triangleIdx] > bestScore)
+						{
+							bestScore = triangleScores[triangleIdx];
+							bestTriangle = triangleIdx;
+						}
+					}
+				}
+
+				if (newCache.size() > cacheSize)
+					newCache.resize(cacheSize);
+
+				std::swap(cache, newCache);
+			}
+
+			indices = std::move(optimizedIndices);
+		}
+
+		//Renumbers the vertices in the order the index buffer first uses them, so vertex fetches walk memory forward
+		static void OptimizeVertexFetch(std::vector<Vertex_PosCol>& vertices, std::vector<uint32_t>& indices)
+		{
+			const AllocationTracker::Scope allocationScope{ Subsystem::utils };
+
+			std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+			std::vector<Vertex_PosCol> reorderedVertices{};
+			reorderedVertices.reserve(vertices.size());
+
+			for (uint32_t& index : indices)
+			{
+				if (remap[index] == UINT32_MAX)
+				{
+					remap[index] = uint32_t(reorderedVertices.size());
+					reorderedVertices.push_back(vertices[index]);
+				}
+
+				index = remap[index];
+			}
+
+			AllocationTracker::CountCopy(reorderedVertices.size() * sizeof(Vertex_PosCol));
+			vertices = std::move(reorderedVertices);
+		}
+
+		//Vertices transformed when drawing through a FIFO post-transform cache, for ACMR (per triangle) and ATVR (per vertex)
+		static size_t SimulateVertexCacheMisses(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16)
+		{
+			const AllocationTracker::Scope allocationScope{ Subsystem::utils };
+
+			std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+			uint32_t timestamp = cacheSize + 1;
+			size_t misses = 0;
+
+			for (const uint32_t index : indices)
+			{
+				if (timestamp - cacheTimestamps[index] > cacheSize)
+				{
+					cacheTimestamps[index] = timestamp++;
+					++misses;
+				}
+			}
+
+			return misses;
+		}
 #pragma warning(pop)
 		}
 	}
\ No newline at end of file
@@ -1,46 +1,156 @@
-#pragma once
-
-namespace dae
-{
-	struct Vector2
-	{
-		float x{};
-		float y{};
-
-		Vector2() = default;
-		Vector2(float _x, float _y);
-		Vector2(const Vector2& from, const Vector2& to);
-
-		float Magnitude() const;
-		float SqrMagnitude() const;
-		float Normalize();
-		Vector2 Normalized() const;
-
-		static float Dot(const Vector2& v1, const Vector2& v2);
-		static float Cross(const Vector2& v1, const Vector2& v2);
-
-		//Member Operators
-		Vector2 operator*(float scale) const;
-		Vector2 operator/(float scale) const;
-		Vector2 operator+(const Vector2& v) const;
-		Vector2 operator-(const Vector2& v) const;
-		Vector2 operator-() const;
-		//Vector2& operator-();
-		Vector2& operator+=(const Vector2& v);
-		Vector2& operator-=(const Vector2& v);
-		Vector2& operator/=(float scale);
-		Vector2& operator*=(float scale);
-		float& operator[](int index);
-		float operator[](int index) const;
-
-		static const Vector2 UnitX;
-		static const Vector2 UnitY;
-		static const Vector2 Zero;
-	};
-
-	//Global Operators
-	inline Vector2 operator*(float scale, const Vector2& v)
-	{
-		return { v.x * scale, v.y * scale };
-	}
-}
+#pragma once
+#include <cassert>
+#include <cmath>
+
+namespace dae
+{
+	struct Vector2
+	{
+		float x{};
+		float y{};
+
+		Vector2() = default;
+		constexpr Vector2(float _x, float _y) : x(_x), y(_y) {}
+		Vector2(const Vector2& from, const Vector2& to);
+
+		float Magnitude() const;
+		float SqrMagnitude() const;
+		float Normalize();
+		Vector2 Normalized() const;
+
+		static float Dot(const Vector2& v1, const Vector2& v2);
+		static float Cross(const Vector2& v1, const Vector2& v2);
+
+		//Member Operators
+		Vector2 operator*(float scale) const;
+		Vector2 operator/(float scale) const;
+		Vector2 operator+(const Vector2& v) const;
+		Vector2 operator-(const Vector2& v) const;
+		Vector2 operator-() const;
+		//Vector2& operator-();
+		Vector2& operator+=(const Vector2& v);
+		Vector2& operator-=(const Vector2& v);
+		Vector2& operator/=(float scale);
+		Vector2& operator*=(float scale);
+		float& operator[](int index);
+		float operator[](int index) const;
+
+		static const Vector2 UnitX;
+		static const Vector2 UnitY;
+		static const Vector2 Zero;
+	};
+
+	//Global Operators
+	inline Vector2 operator*(float scale, const Vector2& v)
+	{
+		return { v.x * scale, v.y * scale };
+	}
+
+	inline const Vector2 Vector2::UnitX{ 1, 0 };
+	inline const Vector2 Vector2::UnitY{ 0, 1 };
+	inline const Vector2 Vector2::Zero{ 0, 0 };
+
+	inline Vector2::Vector2(const Vector2& from, const Vector2& to) : x(to.x - from.x), y(to.y - from.y) {}
+
+	inline float Vector2::Magnitude() const
+	{
+		return sqrtf(x * x + y * y);
+	}
+
+	inline float Vector2::SqrMagnitude() const
+	{
+		return x * x + y * y;
+	}
+
+	inline float Vector2::Normalize()
+	{
+		const float m = Magnitude();
+		x /= m;
+		y /= m;
+
+		return m;
+	}
+
+	inline Vector2 Vector2::Normalized() const
+	{
+		const float m = Magnitude();
+		return { x / m, y / m};
+	}
+
+	inline float Vector2::Dot(const Vector2& v1, const Vector2& v2)
+	{
+		return v1.x * v2.x + v1.y * v2.y;
+	}
+
+	inline float Vector2::Cross(const Vector2& v1, const Vector2& v2)
+	{
+		return v1.x * v2.y - v1.y * v2.x;
+	}
+
+#pragma region Operator Overloads
+	inline Vector2 Vector2::operator*(float scale) const
+	{
+		return { x * scale, y * scale };
+	}
+
+	inline Vector2 Vector2::operator/(float scale) const
+	{
+		return { x / scale, y / scale };
+	}
+
+	inline Vector2 Vector2::operator+(const Vector2& v) const
+	{
+		return { x + v.x, y + v.y };
+	}
+
+	inline Vector2 Vector2::operator-(const Vector2& v) const
+	{
+		return { x - v.x, y - v.y };
+	}
+
+	inline Vector2 Vector2::operator-() const
+	{
+		return { -x ,-y };
+	}
+
+	inline Vector2& Vector2::operator*=(float scale)
+	{
+		x *= scale;
+		y *= scale;
+		return *this;
+	}
+
+	inline Vector2& Vector2::operator/=(float scale)
+	{
+		x /= scale;
+		y /= scale;
+		return *this;
+	}
+
+	inline Vector2& Vector2::operator-=(const Vector2& v)
+	{
+		x -= v.x;
+		y -= v.y;
+		return *this;
+	}
+
+	inline Vector2& Vector2::operator+=(const Vector2& v)
+	{
+		x += v.x;
+		y += v.y;
+		return *this;
+	}
+
+	inline float& Vector2::operator[](int index)
+	{
+		assert(index <= 1 && index >= 0);
+		return index == 0 ? x : y;
+	}
+
+	inline float Vector2::operator[](int index) const
+	{
+		assert(index <= 1 && index >= 0);
+		return index == 0 ? x : y;
+	}
+#pragma endregion
+}
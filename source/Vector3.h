@@ -1,59 +1,206 @@
-#pragma once
-
-namespace dae
-{
-	struct Vector2;
-	struct Vector4;
-	struct Vector3
-	{
-		float x{};
-		float y{};
-		float z{};
-
-		Vector3() = default;
-		Vector3(float _x, float _y, float _z);
-		Vector3(const Vector3& from, const Vector3& to);
-		Vector3(const Vector4& v);
-
-		float Magnitude() const;
-		float SqrMagnitude() const;
-		float Normalize();
-		Vector3 Normalized() const;
-
-		static float Dot(const Vector3& v1, const Vector3& v2);
-		static Vector3 Cross(const Vector3& v1, const Vector3& v2);
-		static Vector3 Project(const Vector3& v1, const Vector3& v2);
-		static Vector3 Reject(const Vector3& v1, const Vector3& v2);
-		static Vector3 Reflect(const Vector3& v1, const Vector3& v2);
-
-		Vector4 ToPoint4() const;
-		Vector4 ToVector4() const;
-
-		Vector2 GetXY() const;
-
-		//Member Operators
-		Vector3 operator*(float scale) const;
-		Vector3 operator/(float scale) const;
-		Vector3 operator+(const Vector3& v) const;
-		Vector3 operator-(const Vector3& v) const;
-		Vector3 operator-() const;
-		//Vector3& operator-();
-		Vector3& operator+=(const Vector3& v);
-		Vector3& operator-=(const Vector3& v);
-		Vector3& operator/=(float scale);
-		Vector3& operator*=(float scale);
-		float& operator[](int index);
-		float operator[](int index) const;
-
-		static const Vector3 UnitX;
-		static const Vector3 UnitY;
-		static const Vector3 UnitZ;
-		static const Vector3 Zero;
-	};
-
-	//Global Operators
-	inline Vector3 operator*(float scale, const Vector3& v)
-	{
-		return { v.x * scale, v.y * scale, v.z * scale };
-	}
-}
+#pragma once
+#include "Vector2.h"
+#include <cassert>
+#include <cmath>
+
+namespace dae
+{
+	//the members that take or return a Vector4 are defined in Vector4.h
+	struct Vector4;
+	struct Vector3
+	{
+		float x{};
+		float y{};
+		float z{};
+
+		Vector3() = default;
+		constexpr Vector3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+		Vector3(const Vector3& from, const Vector3& to);
+		Vector3(const Vector4& v);
+
+		float Magnitude() const;
+		float SqrMagnitude() const;
+		float Normalize();
+		Vector3 Normalized() const;
+
+		static float Dot(const Vector3& v1, const Vector3& v2);
+		static Vector3 Cross(const Vector3& v1, const Vector3& v2);
+		static Vector3 Project(const Vector3& v1, const Vector3& v2);
+		static Vector3 Reject(const Vector3& v1, const Vector3& v2);
+		static Vector3 Reflect(const Vector3& v1, const Vector3& v2);
+
+		Vector4 ToPoint4() const;
+		Vector4 ToVector4() const;
+
+		Vector2 GetXY() const;
+
+		//Member Operators
+		Vector3 operator*(float scale) const;
+		Vector3 operator/(float scale) const;
+		Vector3 operator+(const Vector3& v) const;
+		Vector3 operator-(const Vector3& v) const;
+		Vector3 operator-() const;
+		//Vector3& operator-();
+		Vector3& operator+=(const Vector3& v);
+		Vector3& operator-=(const Vector3& v);
+		Vector3& operator/=(float scale);
+		Vector3& operator*=(float scale);
+		float& operator[](int index);
+		float operator[](int index) const;
+
+		static const Vector3 UnitX;
+		static const Vector3 UnitY;
+		static const Vector3 UnitZ;
+		static const Vector3 Zero;
+	};
+
+	//Global Operators
+	inline Vector3 operator*(float scale, const Vector3& v)
+	{
+		return { v.x * scale, v.y * scale, v.z * scale };
+	}
+
+	inline const Vector3 Vector3::UnitX{ 1, 0, 0 };
+	inline const Vector3 Vector3::UnitY{ 0, 1, 0 };
+	inline const Vector3 Vector3::UnitZ{ 0, 0, 1 };
+	inline const Vector3 Vector3::Zero{ 0, 0, 0 };
+
+	inline Vector3::Vector3(const Vector3& from, const Vector3& to) : x(to.x - from.x), y(to.y - from.y), z(to.z - from.z){}
+
+	inline float Vector3::Magnitude() const
+	{
+		return sqrtf(x * x + y * y + z * z);
+	}
+
+	inline float Vector3::SqrMagnitude() const
+	{
+		return x * x + y * y + z * z;
+	}
+
+	inline float Vector3::Normalize()
+	{
+		const float m = Magnitude();
+		x /= m;
+		y /= m;
+		z /= m;
+
+		return m;
+	}
+
+	inline Vector3 Vector3::Normalized() const
+	{
+		const float m = Magnitude();
+		return { x / m, y / m, z / m };
+	}
+
+	inline float Vector3::Dot(const Vector3& v1, const Vector3& v2)
+	{
+		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+	}
+
+	inline Vector3 Vector3::Cross(const Vector3& v1, const Vector3& v2)
+	{
+		return Vector3{
+			v1.y * v2.z - v1.z * v2.y,
+			v1.z * v2.x - v1.x * v2.z,
+			v1.x * v2.y - v1.y * v2.x
+		};
+	}
+
+	inline Vector3 Vector3::Project(const Vector3& v1, const Vector3& v2)
+	{
+		return (v2 * (Dot(v1, v2) / Dot(v2, v2)));
+	}
+
+	inline Vector3 Vector3::Reject(const Vector3& v1, const Vector3& v2)
+	{
+		return (v1 - v2 * (Dot(v1, v2) / Dot(v2, v2)));
+	}
+
+	inline Vector3 Vector3::Reflect(const Vector3& v1, const Vector3& v2)
+	{
+		return v1 - (2.f * Vector3::Dot(v1, v2) * v2);
+	}
+
+	inline Vector2 Vector3::GetXY() const
+	{
+		return { x, y };
+	}
+
+#pragma region Operator Overloads
+	inline Vector3 Vector3::operator*(float scale) const
+	{
+		return { x * scale, y * scale, z * scale };
+	}
+
+	inline Vector3 Vector3::operator/(float scale) const
+	{
+		return { x / scale, y / scale, z / scale };
+	}
+
+	inline Vector3 Vector3::operator+(const Vector3& v) const
+	{
+		return { x + v.x, y + v.y, z + v.z };
+	}
+
+	inline Vector3 Vector3::operator-(const Vector3& v) const
+	{
+		return { x - v.x, y - v.y, z - v.z };
+	}
+
+	inline Vector3 Vector3::operator-() const
+	{
+		return { -x ,-y,-z };
+	}
+
+	inline Vector3& Vector3::operator*=(float scale)
+	{
+		x *= scale;
+		y *= scale;
+		z *= scale;
+		return *this;
+	}
+
+	inline Vector3& Vector3::operator/=(float scale)
+	{
+		x /= scale;
+		y /= scale;
+		z /= scale;
+		return *this;
+	}
+
+	inline Vector3& Vector3::operator-=(const Vector3& v)
+	{
+		x -= v.x;
+		y -= v.y;
+		z -= v.z;
+		return *this;
+	}
+
+	inline Vector3& Vector3::operator+=(const Vector3& v)
+	{
+		x += v.x;
+		y += v.y;
+		z += v.z;
+		return *this;
+	}
+
+	inline float& Vector3::operator[](int index)
+	{
+		assert(index <= 2 && index >= 0);
+
+		if (index == 0) return x;
+		if (index == 1) return y;
+		return z;
+	}
+
+	inline float Vector3::operator[](int index) const
+	{
+		assert(index <= 2 && index >= 0);
+
+		if (index == 0) return x;
+		if (index == 1) return y;
+		return z;
+	}
+#pragma endregion
+}
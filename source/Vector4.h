@@ -1,36 +1,145 @@
-#pragma once
-
-namespace dae
-{
-	struct Vector2;
-	struct Vector3;
-	struct Vector4
-	{
-		float x;
-		float y;
-		float z;
-		float w;
-
-		Vector4() = default;
-		Vector4(float _x, float _y, float _z, float _w);
-		Vector4(const Vector3& v, float _w);
-
-		float Magnitude() const;
-		float SqrMagnitude() const;
-		float Normalize();
-		Vector4 Normalized() const;
-
-		Vector2 GetXY() const;
-		Vector3 GetXYZ() const;
-
-		static float Dot(const Vector4& v1, const Vector4& v2);
-
-		// operator overloading
-		Vector4 operator*(float scale) const;
-		Vector4 operator+(const Vector4& v) const;
-		Vector4 operator-(const Vector4& v) const;
-		Vector4& operator+=(const Vector4& v);
-		float& operator[](int index);
-		float operator[](int index) const;
-	};
-}
+#pragma once
+#include "Vector2.h"
+#include "Vector3.h"
+#include <cassert>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace dae
+{
+	//aligned so a Vector4 is one SSE register, only SSE2 is used so it runs on every x64 CPU
+	struct alignas(16) Vector4
+	{
+		float x;
+		float y;
+		float z;
+		float w;
+
+		Vector4() = default;
+		constexpr Vector4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+		Vector4(const Vector3& v, float _w);
+		explicit Vector4(__m128 v);
+
+		float Magnitude() const;
+		float SqrMagnitude() const;
+		float Normalize();
+		Vector4 Normalized() const;
+
+		Vector2 GetXY() const;
+		Vector3 GetXYZ() const;
+		__m128 GetSSE() const;
+
+		static float Dot(const Vector4& v1, const Vector4& v2);
+
+		// operator overloading
+		Vector4 operator*(float scale) const;
+		Vector4 operator+(const Vector4& v) const;
+		Vector4 operator-(const Vector4& v) const;
+		Vector4& operator+=(const Vector4& v);
+		float& operator[](int index);
+		float operator[](int index) const;
+	};
+
+	inline Vector4::Vector4(const Vector3& v, float _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
+
+	inline Vector4::Vector4(__m128 v)
+	{
+		_mm_store_ps(&x, v);
+	}
+
+	inline float Vector4::Magnitude() const
+	{
+		return sqrtf(x * x + y * y + z * z + w * w);
+	}
+
+	inline float Vector4::SqrMagnitude() const
+	{
+		return x * x + y * y + z * z + w * w;
+	}
+
+	inline float Vector4::Normalize()
+	{
+		const float m = Magnitude();
+		x /= m;
+		y /= m;
+		z /= m;
+		w /= m;
+
+		return m;
+	}
+
+	inline Vector4 Vector4::Normalized() const
+	{
+		const float m = Magnitude();
+		return { x / m, y / m, z / m, w / m };
+	}
+
+	inline Vector2 Vector4::GetXY() const
+	{
+		return { x, y };
+	}
+
+	inline Vector3 Vector4::GetXYZ() const
+	{
+		return { x,y,z };
+	}
+
+	inline __m128 Vector4::GetSSE() const
+	{
+		return _mm_load_ps(&x);
+	}
+
+	//summed in order like the other vectors, a horizontal add would round differently
+	inline float Vector4::Dot(const Vector4& v1, const Vector4& v2)
+	{
+		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+	}
+
+#pragma region Operator Overloads
+	inline Vector4 Vector4::operator*(float scale) const
+	{
+		return Vector4{ _mm_mul_ps(GetSSE(), _mm_set1_ps(scale)) };
+	}
+
+	inline Vector4 Vector4::operator+(const Vector4& v) const
+	{
+		return Vector4{ _mm_add_ps(GetSSE(), v.GetSSE()) };
+	}
+
+	inline Vector4 Vector4::operator-(const Vector4& v) const
+	{
+		return Vector4{ _mm_sub_ps(GetSSE(), v.GetSSE()) };
+	}
+
+	inline Vector4& Vector4::operator+=(const Vector4& v)
+	{
+		_mm_store_ps(&x, _mm_add_ps(GetSSE(), v.GetSSE()));
+		return *this;
+	}
+
+	inline float& Vector4::operator[](int index)
+	{
+		assert(index <= 3 && index >= 0);
+		return (&x)[index];
+	}
+
+	inline float Vector4::operator[](int index) const
+	{
+		assert(index <= 3 && index >= 0);
+		return (&x)[index];
+	}
+#pragma endregion
+
+	// Vector3 members that need the full Vector4
+	inline Vector3::Vector3(const Vector4& v) : x(v.x), y(v.y), z(v.z) {}
+
+	inline Vector4 Vector3::ToPoint4() const
+	{
+		return { x, y, z, 1 };
+	}
+
+	inline Vector4 Vector3::ToVector4() const
+	{
+		return { x, y, z, 0 };
+	}
+}
@@ -1,125 +1,167 @@
-#include "pch.h"
-
-#if defined(_DEBUG)
-#include "vld.h"
-#endif
-
-#undef main
-#include "Renderer.h"
-
-using namespace dae;
-
-void ShutDown(SDL_Window* pWindow)
-{
-	SDL_DestroyWindow(pWindow);
-	SDL_Quit();
-}
-
-int main(int argc, char* args[])
-{
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
-
-	//Create window + surfaces
-	SDL_Init(SDL_INIT_VIDEO);
-
-	const uint32_t width = 640;
-	const uint32_t height = 480;
-
-	SDL_Window* pWindow = SDL_CreateWindow(
-		"DirectX - Maritte Kindt DAE09",
-		SDL_WINDOWPOS_UNDEFINED,
-		SDL_WINDOWPOS_UNDEFINED,
-		width, height, 0);
-
-	if (!pWindow)
-		return 1;
-
-	//Initialize "framework"
-	const auto pTimer = new Timer();
-	const auto pRenderer = new Renderer(pWindow);
-
-	//Start loop
-	pTimer->Start();
-	float printTimer = 0.f;
-	bool isLooping = true;
-	while (isLooping)
-	{
-		//--------- Get input events ---------
-		SDL_Event e;
-		while (SDL_PollEvent(&e))
-		{
-			switch (e.type)
-			{
-			case SDL_QUIT:
-				isLooping = false;
-				break;
-			case SDL_KEYUP:
-				//SHARED
-				if (e.key.keysym.scancode == SDL_SCANCODE_F1) 
-				{
-					pRenderer->ToggleRenderingSettings();
-				}
-				else if (e.key.keysym.scancode == SDL_SCANCODE_F5) 
-				{
-					pRenderer->ToggleRotation(); 
-				}
-				else if (e.key.keysym.scancode == SDL_SCANCODE_F6) 
-				{
-					//Show Normal Map
-					pRenderer->ToggleNormalMap(); 
-				}
-
-				// HARDWARE SETTINGS
-				else if (e.key.keysym.scancode == SDL_SCANCODE_F4)
-				{
-					pRenderer->ToggleSamplerState();
-				}
-				else if (e.key.keysym.scancode == SDL_SCANCODE_F7) 
-				{
-					pRenderer->ToggleFireMesh();
-				}
-
-				//SOFTWARE SETTINGS
-				else if (e.key.keysym.scancode == SDL_SCANCODE_F2) 
-				{
-					//CosineLambert -> DiffuseLambert -> SpecularPhong -> Combined
-					pRenderer->ToggleShadingModes();
-				}
-				else if (e.key.keysym.scancode == SDL_SCANCODE_F3) 
-				{
-					pRenderer->ToggleRenderModes();
-				}
-
-				break;
-			default: ;
-			}
-		}
-
-		//--------- Update ---------
-		pRenderer->Update(pTimer);
-
-		//--------- Render ---------
-		pRenderer->Render();
-
-		//--------- Timer ---------
-		pTimer->Update();
-		printTimer += pTimer->GetElapsed();
-		if (printTimer >= 1.f)
-		{
-			printTimer = 0.f;
-			std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
-		}
-	}
-	
-
-	pTimer->Stop();
-
-	//Shutdown "framework"
-	delete pRenderer;
-	delete pTimer;
-
-	ShutDown(pWindow);
-	return 0;
+#include "pch.h"
+
+#if defined(_DEBUG)
+#include "vld.h"
+#endif
+
+#undef main
+#include "Renderer.h"
+#include "CpuFeatures.h"
+#include "AllocationTracker.h"
+
+using namespace dae;
+
+void ShutDown(SDL_Window* pWindow)
+{
+	SDL_DestroyWindow(pWindow);
+	SDL_Quit();
+}
+
+int main(int argc, char* args[])
+{
+	//--isa=baseline, --isa=avx2 or --isa=avx512 caps the instruction set the software kernels use
+	InstructionSet instructionSetLimit{ InstructionSet::avx512 };
+	for (int argIdx{ 1 }; argIdx < argc; ++argIdx)
+	{
+		const std::string argument{ args[argIdx] };
+		const std::string isaFlag{ "--isa=" };
+
+		if (argument.rfind(isaFlag, 0) == 0 && !CpuFeatures::ParseInstructionSet(argument.substr(isaFlag.size()), instructionSetLimit))
+		{
+			std::cout << RED_COLOR_TEXT << "Unknown instruction set in " << argument << ", expected baseline, avx2 or avx512" << RESET_COLOR_TEXT << std::endl;
+		}
+	}
+
+	//Create window + surfaces
+	SDL_Init(SDL_INIT_VIDEO);
+
+	const uint32_t width = 640;
+	const uint32_t height = 480;
+
+	SDL_Window* pWindow = SDL_CreateWindow(
+		"DirectX - Maritte Kindt DAE09",
+		SDL_WINDOWPOS_UNDEFINED,
+		SDL_WINDOWPOS_UNDEFINED,
+		width, height, 0);
+
+	if (!pWindow)
+		return 1;
+
+	//Initialize "framework"
+	const auto pTimer = new Timer();
+	const auto pRenderer = new Renderer(pWindow, instructionSetLimit);
+
+	//Loading is not counted as part of the first frame
+	AllocationTracker::EndFrame();
+
+	//Start loop
+	pTimer->Start();
+	float printTimer = 0.f;
+	bool isLooping = true;
+	while (isLooping)
+	{
+		//--------- Get input events ---------
+		SDL_Event e;
+		while (SDL_PollEvent(&e))
+		{
+			switch (e.type)
+			{
+			case SDL_QUIT:
+				isLooping = false;
+				break;
+			case SDL_KEYUP:
+				//SHARED
+				if (e.key.keysym.scancode == SDL_SCANCODE_F1) 
+				{
+					pRenderer->ToggleRenderingSettings();
+				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F5) 
+				{
+					pRenderer->ToggleRotation(); 
+				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F6) 
+				{
+					//Show Normal Map
+					pRenderer->ToggleNormalMap(); 
+				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F4)
+				{
+					pRenderer->ToggleSamplerState();
+				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F11)
+				{
+					pRenderer->PrintMemoryReport();
+				}
+
+				// HARDWARE SETTINGS
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F7) 
+				{
+					pRenderer->ToggleFireMesh();
+				}
+
+				//SOFTWARE SETTINGS
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F2) 
+				{
+					//CosineLambert -> DiffuseLambert -> SpecularPhong -> Combined
+					pRenderer->ToggleShadingModes();
+				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F3) 
+				{
+					pRenderer->ToggleRenderModes();
+				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F8)
+				{
+					pRenderer->ToggleRasterizerKernel();
+				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F9)
+				{
+					pRenderer->ToggleShadingPipeline();
+				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F10)
+				{
+					pRenderer->ToggleCullModes();
+				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F12)
+				{
+					pRenderer->ToggleSpecularPower();
+				}
+
+				break;
+			default: ;
+			}
+		}
+
+		//--------- Update ---------
+		pRenderer->Update(pTimer);
+
+		//--------- Render ---------
+		pRenderer->Render();
+
+		//--------- Timer ---------
+		pTimer->Update();
+		AllocationTracker::EndFrame();
+		printTimer += pTimer->GetElapsed();
+		if (printTimer >= 1.f)
+		{
+			printTimer = 0.f;
+			std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+			pRenderer->PrintTriangleStats();
+
+			//the counts of the last frame, only builds with TRACK_ALLOCATIONS have them
+			if constexpr (AllocationTracker::m_IsEnabled)
+			{
+				AllocationTracker::PrintLastFrame();
+			}
+		}
+	}
+	
+
+	pTimer->Stop();
+
+	//Shutdown "framework"
+	delete pRenderer;
+	delete pTimer;
+
+	ShutDown(pWindow);
+	return 0;
 }
\ No newline at end of file